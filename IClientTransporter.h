@@ -38,6 +38,7 @@
 #ifndef ICLIENTTRANSPORTER_H
 #define ICLIENTTRANSPORTER_H
 
+#include <cstdint>
 #include <string>
 
 #include <rcp_client_transporter.h>
@@ -55,6 +56,13 @@ public:
     virtual void disconnect() = 0;
     virtual void pushData(const char* data, size_t size) const {}
 
+    // send packets of one flush concatenated in frames
+    virtual void setBatch(bool batch) {}
+    virtual void sendStats(uint32_t& packets, uint32_t& frames, uint32_t& buffers) const { packets = 0; frames = 0; buffers = 0; }
+
+    // bytes waiting to be sent, heap payloads handed to pd_queue_mess
+    virtual void memoryUsage(size_t& queuedBytes, size_t& payloads) const { queuedBytes = 0; payloads = 0; }
+
 };
 
 } // namespace rcp
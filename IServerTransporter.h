@@ -38,13 +38,25 @@
 #ifndef ISERVERTRANSPORTER_H
 #define ISERVERTRANSPORTER_H
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include <rcp_server_transporter.h>
 
 namespace rcp
 {
 
+struct ClientQueueStats
+{
+    // numbered by connection, starting at 1
+    uint32_t id;
+    size_t packets;
+    size_t bytes;
+    size_t coalesced;
+    bool evicted;
+};
+
 class IServerTransporter
 {
 public:
@@ -57,6 +69,18 @@ public:
     virtual uint16_t port() const = 0;
     virtual bool isListening() const = 0;
     virtual size_t clientCount() const = 0;
+
+    // per client outbound limits - 0: unlimited
+    virtual void setMaxQueue(size_t bytes) {}
+    virtual void setMaxRate(float updatesPerSecond) {}
+    virtual void clientQueueStats(std::vector<ClientQueueStats>& stats) const {}
+
+    // send packets of one flush concatenated in frames
+    virtual void setBatch(bool batch) {}
+    virtual void sendStats(uint32_t& packets, uint32_t& frames, uint32_t& buffers) const { packets = 0; frames = 0; buffers = 0; }
+
+    // bytes waiting to be sent, heap payloads handed to pd_queue_mess
+    virtual void memoryUsage(size_t& queuedBytes, size_t& payloads) const { queuedBytes = 0; payloads = 0; }
 };
 
 } // namespace rcp
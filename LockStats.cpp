@@ -0,0 +1,146 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#include "LockStats.h"
+
+static int bucket(uint64_t us)
+{
+    int b = 0;
+    while (us > 0 &&
+           b < RCP_LOCK_STATS_BUCKETS-1)
+    {
+        us >>= 1;
+        b++;
+    }
+
+    return b;
+}
+
+static void storeMax(std::atomic<uint64_t>& max, uint64_t v)
+{
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while (v > current &&
+           !max.compare_exchange_weak(current, v, std::memory_order_relaxed))
+    {
+    }
+}
+
+
+namespace rcp
+{
+
+LockStats::LockStats()
+{
+    reset();
+}
+
+const char* LockStats::siteName(LockSite site)
+{
+    switch (site)
+    {
+    case LOCK_SITE_RECEIVED:
+        return "received";
+    case LOCK_SITE_LIST:
+        return "list";
+    case LOCK_SITE_ANY:
+        return "any";
+    case LOCK_SITE_EXPOSE:
+        return "expose";
+    case LOCK_SITE_UPDATE:
+        return "parameterUpdate";
+    case LOCK_SITE_COUNT_:
+        break;
+    }
+
+    return "unknown";
+}
+
+void LockStats::setEnabled(bool enabled)
+{
+    if (enabled &&
+        !m_enabled.load())
+    {
+        reset();
+    }
+
+    m_enabled = enabled;
+}
+
+void LockStats::reset()
+{
+    for (int i=0; i<LOCK_SITE_COUNT_; i++)
+    {
+        Site& s = m_sites[i];
+
+        s.count = 0;
+        s.waitTotal = 0;
+        s.waitMax = 0;
+        s.holdTotal = 0;
+        s.holdMax = 0;
+
+        for (int j=0; j<RCP_LOCK_STATS_BUCKETS; j++)
+        {
+            s.waitHistogram[j] = 0;
+            s.holdHistogram[j] = 0;
+        }
+    }
+}
+
+void LockStats::record(LockSite site, uint64_t wait, uint64_t hold)
+{
+    if (site >= LOCK_SITE_COUNT_)
+    {
+        return;
+    }
+
+    Site& s = m_sites[site];
+
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.waitTotal.fetch_add(wait, std::memory_order_relaxed);
+    s.holdTotal.fetch_add(hold, std::memory_order_relaxed);
+    storeMax(s.waitMax, wait);
+    storeMax(s.holdMax, hold);
+    s.waitHistogram[bucket(wait)].fetch_add(1, std::memory_order_relaxed);
+    s.holdHistogram[bucket(hold)].fetch_add(1, std::memory_order_relaxed);
+}
+
+const LockStats::Site& LockStats::site(LockSite site) const
+{
+    return m_sites[site < LOCK_SITE_COUNT_ ? site : 0];
+}
+
+} // namespace rcp
@@ -0,0 +1,99 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#ifndef RCP_LOCKSTATS_H
+#define RCP_LOCKSTATS_H
+
+#include <atomic>
+#include <cstdint>
+
+// histogram buckets in powers of two microseconds: <1us, <2us, <4us ... >=16ms
+#define RCP_LOCK_STATS_BUCKETS 16
+
+namespace rcp
+{
+
+enum LockSite
+{
+    LOCK_SITE_RECEIVED = 0,
+    LOCK_SITE_LIST,
+    LOCK_SITE_ANY,
+    LOCK_SITE_EXPOSE,
+    LOCK_SITE_UPDATE,
+    LOCK_SITE_COUNT_
+};
+
+// wait- and hold-time of the instance lock per call site
+// recording is off by default and costs one atomic load then
+class LockStats
+{
+public:
+    struct Site
+    {
+        std::atomic<uint32_t> count{0};
+        std::atomic<uint64_t> waitTotal{0};
+        std::atomic<uint64_t> waitMax{0};
+        std::atomic<uint64_t> holdTotal{0};
+        std::atomic<uint64_t> holdMax{0};
+        std::atomic<uint32_t> waitHistogram[RCP_LOCK_STATS_BUCKETS];
+        std::atomic<uint32_t> holdHistogram[RCP_LOCK_STATS_BUCKETS];
+    };
+
+public:
+    LockStats();
+
+    static const char* siteName(LockSite site);
+
+    bool enabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+    void setEnabled(bool enabled);
+    void reset();
+
+    // times in microseconds
+    void record(LockSite site, uint64_t wait, uint64_t hold);
+    const Site& site(LockSite site) const;
+
+private:
+    std::atomic<bool> m_enabled{false};
+    Site m_sites[LOCK_SITE_COUNT_];
+};
+
+} // namespace rcp
+
+#endif // RCP_LOCKSTATS_H
@@ -0,0 +1,187 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#include "OutboundQueue.h"
+
+#include <rcp.h>
+
+static bool valueSize(unsigned char type, const unsigned char* data, size_t size, size_t& outSize)
+{
+    switch (type)
+    {
+    case DATATYPE_BOOLEAN:
+        outSize = 1;
+        return size >= outSize;
+    case DATATYPE_INT32:
+    case DATATYPE_FLOAT32:
+        outSize = 4;
+        return size >= outSize;
+    case DATATYPE_STRING:
+        if (size < 4)
+        {
+            return false;
+        }
+        // long string: 4 byte size prefix
+        outSize = 4 + (((size_t)data[0] << 24) | ((size_t)data[1] << 16) | ((size_t)data[2] << 8) | (size_t)data[3]);
+        return size >= outSize;
+    default:
+        break;
+    }
+
+    return false;
+}
+
+
+namespace rcp
+{
+
+// - updatevalue: 06 id id type value
+// - update: 04 18 id id type 0 32 value 0 0
+bool OutboundQueue::valueKey(const char* data, size_t size, uint16_t& key)
+{
+    const unsigned char* d = (const unsigned char*)data;
+
+    if (size >= 4 &&
+        d[0] == COMMAND_UPDATEVALUE)
+    {
+        key = (uint16_t)((d[1] << 8) | d[2]);
+        return true;
+    }
+
+    if (size >= 9 &&
+        d[0] == COMMAND_UPDATE &&
+        d[1] == PACKET_OPTIONS_DATA &&
+        d[5] == RCP_TERMINATOR &&
+        d[6] == PARAMETER_OPTIONS_VALUE)
+    {
+        size_t value_size = 0;
+        if (valueSize(d[4], d + 7, size - 7, value_size) &&
+            size == 7 + value_size + 2 &&
+            d[7 + value_size] == RCP_TERMINATOR &&
+            d[8 + value_size] == RCP_TERMINATOR)
+        {
+            key = (uint16_t)((d[2] << 8) | d[3]);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void OutboundQueue::push(const SharedPacket& packet)
+{
+    uint16_t key = 0;
+    size_t size = packet->size();
+
+    if (valueKey(packet->data(), size, key))
+    {
+        std::unordered_map<uint16_t, size_t>::iterator it = m_values.find(key);
+
+        if (it != m_values.end() &&
+            it->second >= m_position)
+        {
+            // last value wins
+            SharedPacket& queued = m_packets[it->second - m_position];
+            m_bytes -= queued->size();
+            queued = packet;
+            m_bytes += size;
+            m_coalesced++;
+            return;
+        }
+
+        m_values[key] = m_position + m_packets.size();
+    }
+    else
+    {
+        // keep order: nothing may be moved before this packet
+        m_values.clear();
+    }
+
+    m_packets.push_back(packet);
+    m_bytes += size;
+}
+
+bool OutboundQueue::pop(SharedPacket& packet)
+{
+    if (m_packets.empty())
+    {
+        return false;
+    }
+
+    packet.swap(m_packets.front());
+    m_bytes -= packet->size();
+
+    m_packets.pop_front();
+    m_position++;
+
+    if (m_packets.empty())
+    {
+        m_values.clear();
+    }
+
+    return true;
+}
+
+void OutboundQueue::clear()
+{
+    m_position += m_packets.size();
+    m_packets.clear();
+    m_values.clear();
+    m_bytes = 0;
+}
+
+bool OutboundQueue::empty() const
+{
+    return m_packets.empty();
+}
+
+size_t OutboundQueue::count() const
+{
+    return m_packets.size();
+}
+
+size_t OutboundQueue::bytes() const
+{
+    return m_bytes;
+}
+
+size_t OutboundQueue::coalesced() const
+{
+    return m_coalesced;
+}
+
+} // namespace rcp
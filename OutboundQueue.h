@@ -0,0 +1,91 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#ifndef RCP_OUTBOUNDQUEUE_H
+#define RCP_OUTBOUNDQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// maximum size of a frame when sending packets batched
+#define RCP_BATCH_FRAME_SIZE 16384
+
+namespace rcp
+{
+
+// immutable serialized packet, shared by all client queues it was sent to
+typedef std::shared_ptr<const std::vector<char> > SharedPacket;
+
+// packets waiting to be sent to one client
+// a value-only packet replaces a queued value-only packet of the same parameter,
+// as long as no other packet (add, remove, full update, ...) was queued in between
+class OutboundQueue
+{
+public:
+    void push(const SharedPacket& packet);
+
+    // move the oldest packet into packet
+    bool pop(SharedPacket& packet);
+    void clear();
+
+    bool empty() const;
+    size_t count() const;
+    size_t bytes() const;
+    size_t coalesced() const;
+
+    // key of a packet only carrying the value of one parameter
+    static bool valueKey(const char* data, size_t size, uint16_t& key);
+
+private:
+    std::deque<SharedPacket> m_packets;
+
+    // parameter key -> absolute position of its queued value packet
+    std::unordered_map<uint16_t, size_t> m_values;
+    // absolute position of m_packets.front()
+    size_t m_position{0};
+
+    size_t m_bytes{0};
+    size_t m_coalesced{0};
+};
+
+} // namespace rcp
+
+#endif // RCP_OUTBOUNDQUEUE_H
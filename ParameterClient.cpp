@@ -87,32 +87,6 @@ static void bangCb(rcp_bang_parameter* param, void* user)
 }
 
 
-// synchronized from threaded transporter
-
-static void pd_id_parameter_output(t_pd *obj, void *data)
-{
-    std::vector<t_atom>* _list = (std::vector<t_atom>*)data;
-
-    if (obj != NULL)
-    {
-        t_rabbit_client_pd* x = (t_rabbit_client_pd*)obj;
-
-        if (_list &&
-            _list->size() > 1 &&
-            (_list->data()+1)->a_type == A_SYMBOL)
-        {
-            outlet_float(x->parameter_id_out, (*_list)[0].a_w.w_float);
-            outlet_anything(x->parameter_out, (_list->data()+1)->a_w.w_symbol, _list->size()-2, _list->data()+2);
-        }
-    }
-
-    if (_list)
-    {
-        delete _list;
-    }
-}
-
-
 namespace rcp
 {
 
@@ -131,6 +105,8 @@ ParameterClient::ParameterClient(t_rabbit_client_pd* x, int argc, t_atom *argv)
                m_x->info_out);
 
 
+    bool batch = false;
+
     // check arguments
     for (int i = 0; i < argc; ++i)
     {
@@ -140,6 +116,18 @@ ParameterClient::ParameterClient(t_rabbit_client_pd* x, int argc, t_atom *argv)
             {
                 m_raw = true;
             }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@defer") == 0)
+            {
+                m_defer = true;
+            }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@lockstats") == 0)
+            {
+                setLockStats(true);
+            }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@batch") == 0)
+            {
+                batch = true;
+            }
 
             // other arguments?
         }
@@ -156,7 +144,7 @@ ParameterClient::ParameterClient(t_rabbit_client_pd* x, int argc, t_atom *argv)
     }
     else
     {
-        m_transporter = new WebsocketClientTransporter((t_pd*)x);
+        m_transporter = new WebsocketClientTransporter((t_pd*)x, this);
     }
 
     if (!m_transporter)
@@ -164,6 +152,8 @@ ParameterClient::ParameterClient(t_rabbit_client_pd* x, int argc, t_atom *argv)
         throw std::runtime_error("could not create rcp client transporter");
     }
 
+    m_transporter->setBatch(batch);
+
     // create client
     m_client = rcp_client_create(m_transporter->transporter());
 
@@ -217,8 +207,9 @@ void ParameterClient::connect(string url)
 {
     if (m_transporter)
     {
-        std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+        Threading::Lock lock(m_mutex);
 
+        m_index.clear();
         m_transporter->connect(url);
     }
 }
@@ -227,45 +218,69 @@ void ParameterClient::disconnect()
 {
     if (m_transporter)
     {
-        std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+        Threading::Lock lock(m_mutex);
 
         m_transporter->disconnect();
+        m_index.clear();
+    }
+}
+
+void ParameterClient::setBatch(bool batch)
+{
+    if (m_transporter)
+    {
+        m_transporter->setBatch(batch);
+    }
+}
+
+void ParameterClient::outputSendStats() const
+{
+    uint32_t packets = 0;
+    uint32_t frames = 0;
+    uint32_t buffers = 0;
+
+    if (m_transporter)
+    {
+        m_transporter->sendStats(packets, frames, buffers);
     }
+
+    // sendstats <packets> <frames> <buffers allocated>
+    t_atom list[3];
+    setFloat(list[0], packets);
+    setFloat(list[1], frames);
+    setFloat(list[2], buffers);
+
+    outlet_anything(m_x->info_out, gensym("sendstats"), 3, list);
 }
 
 
 // threaded - called from transporter thread
 void ParameterClient::parameterAddedThreaded(rcp_parameter* parameter)
 {
+    Threading::Lock lock(m_mutex);
+
     const char* label = rcp_parameter_get_label(parameter);
     uint16_t id = rcp_parameter_get_id(parameter);
 
-    // get the parents
-    std::vector<std::string> groups = getParents(parameter);
+    index().add(parameter);
 
-    // cout << "add - parents: " << groups.size() << "\n";
+    // get the parents
+    std::vector<t_symbol*> buffer;
+    const std::vector<t_symbol*>& path = getPath(parameter, buffer);
 
     // output [list]
     // add group1 groupN... label value
 
     // TODO: append userid?
 
-    int len = 1 + 3 + groups.size();
-    std::vector<t_atom>* _list = new std::vector<t_atom>(len);
-    std::vector<t_atom>& list = *_list;
+    ParameterMessage message(id, gensym("add"), 2 + path.size());
+    t_atom* list = message.atoms();
 
     int i=0;
 
-    setFloat(list[i], id);
-    i++;
-
-    setSymbol(list[i], gensym("add"));
-    i++;
-
-    for (std::vector<std::string>::reverse_iterator rit = groups.rbegin();
-         rit != groups.rend(); ++rit)
+    for (size_t j=0; j<path.size(); j++)
     {
-        setString(list[i], rit->c_str());
+        setSymbol(list[i], path[j]);
         i++;
     }
 
@@ -321,53 +336,47 @@ void ParameterClient::parameterAddedThreaded(rcp_parameter* parameter)
         i++;
     }
 
+    message.argc = i;
+
     // output list
-    pd_queue_mess(&pd_maininstance, (t_pd*)m_x, _list, pd_id_parameter_output);
+    queueMessage(message);
 }
 
 void ParameterClient::parameterRemovedThreaded(rcp_parameter* parameter)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
 
     const char* label = rcp_parameter_get_label(parameter);
     uint16_t id = rcp_parameter_get_id(parameter);
 
     // get the parents
-    std::vector<std::string> groups = getParents(parameter);
+    std::vector<t_symbol*> buffer;
+    const std::vector<t_symbol*>& path = getPath(parameter, buffer);
 
     // output [list]
     // remove group1 groupN... label
 
-    int len = 1 + 2 + groups.size();
-    std::vector<t_atom>* _list = new std::vector<t_atom>(len);
-    std::vector<t_atom>& list = *_list;
+    ParameterMessage message(id, gensym("remove"), 1 + path.size());
+    t_atom* list = message.atoms();
 
     int i=0;
 
-    setFloat(list[i], id);
-    i++;
-
-    setSymbol(list[i], gensym("remove"));
-    i++;
-
-    for (std::vector<std::string>::reverse_iterator rit = groups.rbegin();
-         rit != groups.rend(); ++rit)
+    for (size_t j=0; j<path.size(); j++)
     {
-        setString(list[i], rit->c_str());
+        setSymbol(list[i], path[j]);
         i++;
     }
 
     setSymbol(list[i], gensym(label != NULL ? label : "<nolabel>"));
     i++;
 
-    // output list
-    pd_queue_mess(&pd_maininstance, (t_pd*)m_x, _list, pd_id_parameter_output);
-}
+    message.argc = i;
+
+    // path is gone with it
+    index().remove(parameter);
 
-void ParameterClient::outputIdParameterList(std::vector<t_atom>* list)
-{
     // output list
-    pd_queue_mess(&pd_maininstance, (t_pd*)m_x, list, pd_id_parameter_output);
+    queueMessage(message);
 }
 
 void ParameterClient::handleRawData(char* data, size_t size)
@@ -378,5 +387,16 @@ void ParameterClient::handleRawData(char* data, size_t size)
     }
 }
 
+void ParameterClient::transporterMemory(size_t& queuedBytes, size_t& payloads) const
+{
+    queuedBytes = 0;
+    payloads = 0;
+
+    if (m_transporter)
+    {
+        m_transporter->memoryUsage(queuedBytes, payloads);
+    }
+}
+
 } // namespace rcp
 
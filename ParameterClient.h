@@ -61,13 +61,17 @@ public:
     void connect(string url);
     void disconnect();
 
+    // send packets of one flush in few frames
+    void setBatch(bool batch);
+    void outputSendStats() const;
+
     void parameterAddedThreaded(rcp_parameter* parameter);
     void parameterRemovedThreaded(rcp_parameter* parameter);
 
 private:
     //
-    void outputIdParameterList(std::vector<t_atom>* list) override;
     void handleRawData(char* data, size_t size) override;
+    void transporterMemory(size_t& queuedBytes, size_t& payloads) const override;
 
 private:
     rcp_group_parameter* createGroups(int argc, t_atom* argv, std::string& outLabel);
@@ -0,0 +1,436 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#include "ParameterIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace rcp
+{
+
+void ParameterIndex::add(rcp_parameter* parameter)
+{
+    if (parameter == NULL)
+    {
+        return;
+    }
+
+    uint16_t id = (uint16_t)rcp_parameter_get_id(parameter);
+    rcp_group_parameter* parent = rcp_parameter_get_parent(parameter);
+
+    std::pair<std::unordered_map<rcp_parameter*, Node>::iterator, bool> node =
+            m_nodes.insert(std::make_pair(parameter, Node()));
+
+    if (node.second)
+    {
+        m_children[parent].push_back(parameter);
+    }
+    else
+    {
+        if (node.first->second.id != id)
+        {
+            setId(node.first->second.id, parameter, NULL);
+        }
+
+        if (node.first->second.parent != parent)
+        {
+            // moved
+            unlink(parameter, node.first->second.parent);
+            m_children[parent].push_back(parameter);
+        }
+    }
+
+    node.first->second.parent = parent;
+    node.first->second.id = id;
+
+    setId(id, parameter, parameter);
+
+    // drop the key of a relabelled or moved parameter
+    std::unordered_map<rcp_parameter*, Path>::iterator old = m_paths.find(parameter);
+    if (old != m_paths.end())
+    {
+        Key old_key;
+        old_key.group = old->second.groups.empty() ? NULL : old->second.groups.back();
+        old_key.label = old->second.label;
+
+        std::unordered_map<Key, rcp_parameter*, KeyHash>::iterator it = m_parameters.find(old_key);
+        if (it != m_parameters.end() &&
+            it->second == parameter)
+        {
+            m_parameters.erase(it);
+        }
+    }
+
+    const char* label = rcp_parameter_get_label(parameter);
+    if (label == NULL)
+    {
+        m_paths.erase(parameter);
+        return;
+    }
+
+    Key key;
+    key.group = parent;
+    key.label = gensym(label);
+
+    // first one wins - same as a search in the group
+    // unless the first one was relabelled or moved since
+    std::pair<std::unordered_map<Key, rcp_parameter*, KeyHash>::iterator, bool> inserted =
+            m_parameters.insert(std::make_pair(key, parameter));
+    if (!inserted.second &&
+        !matches(inserted.first->second, key))
+    {
+        inserted.first->second = parameter;
+    }
+
+    // path
+    Path& entry = m_paths[parameter];
+    entry.label = key.label;
+    entry.parents.clear();
+    entry.groups.clear();
+
+    while (parent != NULL)
+    {
+        const char* parent_label = rcp_parameter_get_label(RCP_PARAMETER(parent));
+        entry.parents.push_back(gensym(parent_label != NULL ? parent_label : "null"));
+        entry.groups.push_back(parent);
+
+        parent = rcp_parameter_get_parent(RCP_PARAMETER(parent));
+    }
+
+    std::reverse(entry.parents.begin(), entry.parents.end());
+    std::reverse(entry.groups.begin(), entry.groups.end());
+}
+
+void ParameterIndex::remove(rcp_parameter* parameter)
+{
+    std::unordered_map<rcp_parameter*, Node>::iterator node = m_nodes.find(parameter);
+    if (node == m_nodes.end())
+    {
+        return;
+    }
+
+    unlink(parameter, node->second.parent);
+    erase(parameter);
+
+    // groups are the keys of m_children - nothing to ask rcp
+    removeChildren(RCP_GROUP_PARAMETER(parameter));
+}
+
+void ParameterIndex::removeChildren(rcp_group_parameter* group)
+{
+    std::unordered_map<rcp_group_parameter*, std::vector<rcp_parameter*> >::iterator it = m_children.find(group);
+    if (it == m_children.end())
+    {
+        return;
+    }
+
+    std::vector<rcp_parameter*> children;
+    children.swap(it->second);
+    m_children.erase(it);
+
+    for (size_t i=0; i<children.size(); i++)
+    {
+        erase(children[i]);
+        removeChildren(RCP_GROUP_PARAMETER(children[i]));
+    }
+}
+
+void ParameterIndex::erase(rcp_parameter* parameter)
+{
+    // erase by the key it was added with - it may have been relabelled since
+    std::unordered_map<rcp_parameter*, Path>::iterator entry = m_paths.find(parameter);
+    if (entry != m_paths.end())
+    {
+        Key key;
+        key.group = entry->second.groups.empty() ? NULL : entry->second.groups.back();
+        key.label = entry->second.label;
+
+        std::unordered_map<Key, rcp_parameter*, KeyHash>::iterator it = m_parameters.find(key);
+        if (it != m_parameters.end() &&
+            it->second == parameter)
+        {
+            m_parameters.erase(it);
+        }
+
+        m_paths.erase(entry);
+    }
+
+    std::unordered_map<rcp_parameter*, Node>::iterator node = m_nodes.find(parameter);
+    if (node != m_nodes.end())
+    {
+        setId(node->second.id, parameter, NULL);
+        m_nodes.erase(node);
+    }
+}
+
+void ParameterIndex::unlink(rcp_parameter* parameter, rcp_group_parameter* parent)
+{
+    std::unordered_map<rcp_group_parameter*, std::vector<rcp_parameter*> >::iterator it = m_children.find(parent);
+    if (it == m_children.end())
+    {
+        return;
+    }
+
+    std::vector<rcp_parameter*>& children = it->second;
+    std::vector<rcp_parameter*>::iterator child = std::find(children.begin(), children.end(), parameter);
+    if (child != children.end())
+    {
+        // order of siblings does not matter
+        *child = children.back();
+        children.pop_back();
+    }
+
+    if (children.empty())
+    {
+        m_children.erase(it);
+    }
+}
+
+void ParameterIndex::clear()
+{
+    m_parameters.clear();
+    m_paths.clear();
+    m_nodes.clear();
+    m_children.clear();
+
+    for (size_t i=0; i<256; i++)
+    {
+        m_ids[i].clear();
+    }
+
+    m_invalid = false;
+}
+
+void ParameterIndex::invalidate()
+{
+    m_invalid = true;
+}
+
+void ParameterIndex::validate(rcp_manager* manager)
+{
+    if (m_invalid)
+    {
+        rebuild(manager);
+    }
+}
+
+void ParameterIndex::rebuild(rcp_manager* manager)
+{
+    clear();
+
+    if (manager == NULL)
+    {
+        return;
+    }
+
+    rcp_parameter_list* list = rcp_manager_get_paramter_list(manager);
+    while (list != NULL)
+    {
+        add(list->parameter);
+        list = list->next;
+    }
+}
+
+void ParameterIndex::setId(uint16_t id, rcp_parameter* parameter, rcp_parameter* value)
+{
+    std::vector<rcp_parameter*>& block = m_ids[id >> 8];
+
+    if (block.empty())
+    {
+        if (value == NULL)
+        {
+            return;
+        }
+
+        block.resize(256, NULL);
+    }
+
+    // clear only our own slot
+    if (value != NULL ||
+        block[id & 0xff] == parameter)
+    {
+        block[id & 0xff] = value;
+    }
+}
+
+rcp_parameter* ParameterIndex::find(rcp_group_parameter* group, t_symbol* label) const
+{
+    if (m_invalid)
+    {
+        return NULL;
+    }
+
+    Key key;
+    key.group = group;
+    key.label = label;
+
+    std::unordered_map<Key, rcp_parameter*, KeyHash>::const_iterator it = m_parameters.find(key);
+    if (it != m_parameters.end())
+    {
+        return it->second;
+    }
+
+    return NULL;
+}
+
+rcp_parameter* ParameterIndex::find(int16_t id) const
+{
+    if (m_invalid)
+    {
+        return NULL;
+    }
+
+    const std::vector<rcp_parameter*>& block = m_ids[(uint16_t)id >> 8];
+
+    if (block.empty())
+    {
+        return NULL;
+    }
+
+    return block[(uint16_t)id & 0xff];
+}
+
+void ParameterIndex::setVerify(bool verify)
+{
+    m_verify = verify;
+}
+
+bool ParameterIndex::verify() const
+{
+    return m_verify;
+}
+
+const std::vector<t_symbol*>* ParameterIndex::path(rcp_parameter* parameter)
+{
+    const Path* entry = refresh(parameter);
+    if (entry != NULL)
+    {
+        return &entry->parents;
+    }
+
+    return NULL;
+}
+
+t_symbol* ParameterIndex::label(rcp_parameter* parameter)
+{
+    const Path* entry = refresh(parameter);
+    if (entry != NULL)
+    {
+        return entry->label;
+    }
+
+    return NULL;
+}
+
+bool ParameterIndex::matches(rcp_parameter* parameter, const Key& key)
+{
+    const char* label = rcp_parameter_get_label(parameter);
+
+    return rcp_parameter_get_parent(parameter) == key.group &&
+            label != NULL &&
+            strcmp(label, key.label->s_name) == 0;
+}
+
+bool ParameterIndex::current(rcp_parameter* parameter, const Path& path)
+{
+    const char* label = rcp_parameter_get_label(parameter);
+    if (label == NULL ||
+        strcmp(label, path.label->s_name) != 0)
+    {
+        return false;
+    }
+
+    // walk up - every parent must still be the same group with the same label
+    size_t i = path.groups.size();
+    rcp_group_parameter* parent = rcp_parameter_get_parent(parameter);
+    while (parent != NULL)
+    {
+        if (i == 0 ||
+            path.groups[i-1] != parent)
+        {
+            return false;
+        }
+
+        i--;
+
+        const char* parent_label = rcp_parameter_get_label(RCP_PARAMETER(parent));
+        if (strcmp(parent_label != NULL ? parent_label : "null", path.parents[i]->s_name) != 0)
+        {
+            return false;
+        }
+
+        parent = rcp_parameter_get_parent(RCP_PARAMETER(parent));
+    }
+
+    return i == 0;
+}
+
+const ParameterIndex::Path* ParameterIndex::refresh(rcp_parameter* parameter)
+{
+    if (m_invalid)
+    {
+        return NULL;
+    }
+
+    std::unordered_map<rcp_parameter*, Path>::iterator it = m_paths.find(parameter);
+    if (it == m_paths.end())
+    {
+        return NULL;
+    }
+
+    if (m_verify &&
+        !current(parameter, it->second))
+    {
+        add(parameter);
+
+        it = m_paths.find(parameter);
+        if (it == m_paths.end())
+        {
+            return NULL;
+        }
+    }
+
+    return &it->second;
+}
+
+size_t ParameterIndex::size() const
+{
+    return m_parameters.size();
+}
+
+} // namespace rcp
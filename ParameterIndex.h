@@ -0,0 +1,155 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#ifndef RCP_PARAMETERINDEX_H
+#define RCP_PARAMETERINDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <rcp_manager.h>
+#include <rcp_parameter.h>
+
+#include <m_pd.h>
+
+namespace rcp
+{
+
+// parameter by (parent group, label)
+// labels are pd symbols, so a lookup hashes and compares pointers only
+// also keeps the path (parent group labels) of every parameter
+// a remote server may relabel or move parameters: with verify on, path and label
+// are checked against the parameter (one strcmp per level) and refreshed when stale
+// and a two-level table of parameters by id (256 blocks of 256, allocated when used)
+class ParameterIndex
+{
+public:
+    void add(rcp_parameter* parameter);
+    // removes parameter and - for groups - everything below it
+    // does not call into rcp: parameter may already be freed
+    void remove(rcp_parameter* parameter);
+    void clear();
+
+    // off: labels and parents only change through add() - no check per lookup
+    void setVerify(bool verify);
+    bool verify() const;
+
+    // any thread: lookups miss until the next validate()
+    void invalidate();
+    // rebuild from manager if invalidated - call before using the index
+    void validate(rcp_manager* manager);
+    void rebuild(rcp_manager* manager);
+
+    // NULL if not in index
+    rcp_parameter* find(rcp_group_parameter* group, t_symbol* label) const;
+
+    // NULL if not in index
+    rcp_parameter* find(int16_t id) const;
+
+    // parent group labels, root first - NULL if not in index
+    const std::vector<t_symbol*>* path(rcp_parameter* parameter);
+    // current label - NULL if not in index
+    t_symbol* label(rcp_parameter* parameter);
+
+    size_t size() const;
+
+private:
+    struct Key
+    {
+        rcp_group_parameter* group;
+        t_symbol* label;
+
+        bool operator==(const Key& other) const
+        {
+            return group == other.group && label == other.label;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            size_t h = (size_t)key.group;
+            return h ^ ((size_t)key.label + 0x9e3779b9 + (h << 6) + (h >> 2));
+        }
+    };
+
+    // parent and id as added - removal must not ask rcp, the parameter may be freed
+    struct Node
+    {
+        rcp_group_parameter* parent;
+        uint16_t id;
+    };
+
+    void removeChildren(rcp_group_parameter* group);
+    // drop key, path and id of parameter - uses stored data only
+    void erase(rcp_parameter* parameter);
+    void unlink(rcp_parameter* parameter, rcp_group_parameter* parent);
+
+    void setId(uint16_t id, rcp_parameter* parameter, rcp_parameter* value);
+
+    std::unordered_map<Key, rcp_parameter*, KeyHash> m_parameters;
+    struct Path
+    {
+        std::vector<t_symbol*> parents;
+        // parent groups, root first
+        std::vector<rcp_group_parameter*> groups;
+        t_symbol* label;
+    };
+
+    // parent and label of parameter still match key
+    static bool matches(rcp_parameter* parameter, const Key& key);
+    // parameter and its parents still match path
+    static bool current(rcp_parameter* parameter, const Path& path);
+    // re-add if stale - NULL if not in index
+    const Path* refresh(rcp_parameter* parameter);
+
+    std::unordered_map<rcp_parameter*, Path> m_paths;
+    // every added parameter - labelled or not
+    std::unordered_map<rcp_parameter*, Node> m_nodes;
+    std::unordered_map<rcp_group_parameter*, std::vector<rcp_parameter*> > m_children;
+    std::vector<rcp_parameter*> m_ids[256];
+    std::atomic<bool> m_invalid{false};
+    bool m_verify{true};
+};
+
+} // namespace rcp
+
+#endif // RCP_PARAMETERINDEX_H
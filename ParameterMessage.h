@@ -0,0 +1,93 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#ifndef RCP_PARAMETERMESSAGE_H
+#define RCP_PARAMETERMESSAGE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <m_pd.h>
+
+// atoms stored inline - enough for: <group> x 14 <label> <value>
+#define RCP_PARAMETER_MESSAGE_ATOMS 16
+
+namespace rcp
+{
+
+// one message for the parameter outlets:
+// <id> to the id outlet, <selector> <atoms> to the parameter outlet
+class ParameterMessage
+{
+public:
+    ParameterMessage()
+    {}
+
+    ParameterMessage(int16_t id, t_symbol* selector, int size)
+        : id(id)
+        , selector(selector)
+    {
+        if (size > RCP_PARAMETER_MESSAGE_ATOMS)
+        {
+            longArgv.resize(size);
+        }
+    }
+
+    // storage for the size given in the constructor
+    t_atom* atoms()
+    {
+        return longArgv.empty() ? argv : longArgv.data();
+    }
+
+    bool isLong() const
+    {
+        return !longArgv.empty();
+    }
+
+public:
+    int16_t id{0};
+    t_symbol* selector{nullptr};
+    int argc{0};
+
+private:
+    t_atom argv[RCP_PARAMETER_MESSAGE_ATOMS];
+    std::vector<t_atom> longArgv;
+};
+
+} // namespace rcp
+
+#endif // RCP_PARAMETERMESSAGE_H
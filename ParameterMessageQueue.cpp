@@ -0,0 +1,191 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#include "ParameterMessageQueue.h"
+
+namespace rcp
+{
+
+ParameterMessageQueue::ParameterMessageQueue(IParameterMessageOutput& output, size_t capacity, size_t poolSize)
+    : m_output(output)
+    , m_poolSize(poolSize)
+    , m_messages(capacity)
+{
+}
+
+ParameterMessageQueue::~ParameterMessageQueue()
+{
+    for (size_t i=0; i<m_pool.size(); i++)
+    {
+        delete m_pool[i];
+    }
+    m_pool.clear();
+}
+
+void ParameterMessageQueue::push(ParameterMessage& message)
+{
+    if (!message.isLong() &&
+        m_overflowPending.load() == 0 &&
+        m_messages.push(message))
+    {
+        m_queued++;
+
+        // one drain per batch
+        if (!m_scheduled.exchange(true))
+        {
+            m_output.scheduleDrain();
+        }
+
+        return;
+    }
+
+    // ring is full or message does not fit - send it on its own
+    m_overflowed++;
+    m_overflowPending++;
+
+    if (message.isLong())
+    {
+        // its atoms were allocated
+        m_allocated++;
+    }
+
+    OverflowMessage* msg = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+
+        if (!m_pool.empty())
+        {
+            msg = m_pool.back();
+            m_pool.pop_back();
+        }
+    }
+
+    if (msg == nullptr)
+    {
+        msg = new OverflowMessage();
+        m_allocated++;
+    }
+
+    msg->owner = this;
+    // reuses the atom storage of a recycled message
+    msg->message = message;
+
+    m_output.scheduleOverflow(msg);
+}
+
+void ParameterMessageQueue::drain()
+{
+    m_scheduled = false;
+
+    // only output what is here now - later messages schedule a new drain
+    size_t count = m_messages.size();
+
+    while (count > 0)
+    {
+        ParameterMessage* message = m_messages.front();
+        if (message == nullptr)
+        {
+            break;
+        }
+
+        m_output.outputMessage(*message);
+        m_messages.pop();
+        count--;
+    }
+}
+
+void ParameterMessageQueue::outputOverflow(OverflowMessage* message)
+{
+    m_output.outputMessage(message->message);
+    m_overflowPending--;
+
+    release(message);
+}
+
+void ParameterMessageQueue::release(OverflowMessage* message)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+
+        if (m_pool.size() < m_poolSize)
+        {
+            m_pool.push_back(message);
+            return;
+        }
+    }
+
+    delete message;
+}
+
+size_t ParameterMessageQueue::size() const
+{
+    return m_messages.size();
+}
+
+size_t ParameterMessageQueue::capacity() const
+{
+    return m_messages.capacity();
+}
+
+size_t ParameterMessageQueue::overflowPending() const
+{
+    return m_overflowPending.load();
+}
+
+size_t ParameterMessageQueue::queued() const
+{
+    return m_queued.load();
+}
+
+size_t ParameterMessageQueue::overflowed() const
+{
+    return m_overflowed.load();
+}
+
+size_t ParameterMessageQueue::allocated() const
+{
+    return m_allocated.load();
+}
+
+size_t ParameterMessageQueue::pooled() const
+{
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    return m_pool.size();
+}
+
+} // namespace rcp
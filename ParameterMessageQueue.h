@@ -0,0 +1,123 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#ifndef RCP_PARAMETERMESSAGEQUEUE_H
+#define RCP_PARAMETERMESSAGEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "ParameterMessage.h"
+#include "SpscRing.h"
+
+namespace rcp
+{
+
+class ParameterMessageQueue;
+
+// a message handed to the pd thread on its own
+struct OverflowMessage
+{
+    ParameterMessageQueue* owner;
+    ParameterMessage message;
+};
+
+// moves work to the pd thread (pd_queue_mess) and outputs messages there
+class IParameterMessageOutput
+{
+public:
+    virtual ~IParameterMessageOutput() {}
+
+    // producer - have drain() called once
+    virtual void scheduleDrain() = 0;
+    // producer - have outputOverflow(message) called
+    virtual void scheduleOverflow(OverflowMessage* message) = 0;
+    // pd thread
+    virtual void outputMessage(ParameterMessage& message) = 0;
+};
+
+// parameter messages from the transporter threads to the pd thread
+// short messages go through a preallocated ring, drained once per batch
+// a message the ring can not take (full, long) and all after it go on their own,
+// until the last of them is output - this keeps the order
+class ParameterMessageQueue
+{
+public:
+    ParameterMessageQueue(IParameterMessageOutput& output, size_t capacity, size_t poolSize);
+    ~ParameterMessageQueue();
+
+    // producer - one at a time (callers serialize with their mutex)
+    void push(ParameterMessage& message);
+
+    // pd thread - output what is in the ring now
+    void drain();
+    // pd thread - output one overflow message and recycle it
+    void outputOverflow(OverflowMessage* message);
+
+    size_t size() const;
+    size_t capacity() const;
+    // messages outside of the ring
+    size_t overflowPending() const;
+    size_t queued() const;
+    size_t overflowed() const;
+    size_t allocated() const;
+    size_t pooled() const;
+
+private:
+    void release(OverflowMessage* message);
+
+    IParameterMessageOutput& m_output;
+    size_t m_poolSize;
+
+    // single producer, single consumer (pd thread)
+    SpscRing<ParameterMessage> m_messages;
+    std::atomic<bool> m_scheduled{false};
+    std::atomic<int> m_overflowPending{0};
+    std::atomic<size_t> m_queued{0};
+    std::atomic<size_t> m_overflowed{0};
+
+    // recycled overflow messages
+    mutable std::mutex m_poolMutex;
+    std::vector<OverflowMessage*> m_pool;
+    std::atomic<size_t> m_allocated{0};
+};
+
+} // namespace rcp
+
+#endif // RCP_PARAMETERMESSAGEQUEUE_H
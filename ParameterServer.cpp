@@ -37,6 +37,14 @@
 
 #include "ParameterServer.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
 #include <rcp_parameter.h>
 #include <rcp_typedefinition.h>
 
@@ -44,9 +52,11 @@
 
 #include "PdMaxUtils.h"
 #include "Optional.h"
+#include "ParameterState.h"
 #include "PdServerTransporter.h"
 #include "Threading.h"
 #include "rabbit.server.h"
+#include "SchemaLoader.h"
 #include "WebsocketServerTransporter.h"
 
 using namespace PdMaxUtils;
@@ -68,31 +78,20 @@ static void bangCb(rcp_bang_parameter* param, void* user)
     }
 }
 
-// synchronized from threaded transporters
-
-static void pd_id_parameter_output(t_pd *obj, void *data)
+static void _transaction_clock_tick(rcp::ParameterServer* x)
 {
-    std::vector<t_atom>* _list = (std::vector<t_atom>*)data;
-
-    if (obj != NULL)
-    {
-        t_rabbit_server_pd* x = (t_rabbit_server_pd*)obj;
-
-        if (_list &&
-            _list->size() > 1 &&
-            (_list->data()+1)->a_type == A_SYMBOL)
-        {
-            outlet_float(x->parameter_id_out, (*_list)[0].a_w.w_float);
-            outlet_anything(x->parameter_out, (_list->data()+1)->a_w.w_symbol, _list->size()-2, _list->data()+2);
-        }
-    }
+    x->transactionTimeout();
+}
 
-    if (_list)
-    {
-        delete _list;
-    }
+static void _info_clock_tick(rcp::ParameterServer* x)
+{
+    x->outputPendingInfo();
 }
 
+static double clampNumber(double value, double min, double max)
+{
+    return std::max(min, std::min(max, value));
+}
 
 namespace rcp
 {
@@ -105,6 +104,20 @@ ParameterServer::ParameterServer(t_rabbit_server_pd* x, int argc, t_atom *argv)
     // init pd struct
     m_x->clients = 0;
 
+    // everything we expose or create goes through createParameter or findOrCreateGroup
+    m_indexComplete = true;
+    // no label or parent is changed after that - a relabel or move would have to add() again
+    m_index.setVerify(false);
+
+    m_transactionClock = clock_new(this, (t_method)_transaction_clock_tick);
+    m_infoClock = clock_new(this, (t_method)_info_clock_tick);
+
+    // outlets are not connected yet - hold back info from @schema and @state
+    m_deferInfo = true;
+
+    // only valid while the object is created
+    m_dir = canvas_getcurrentdir();
+
     m_x->parameter_out = outlet_new(&m_x->x_obj, &s_list);
     m_x->parameter_id_out = outlet_new(&m_x->x_obj, &s_float);
     m_x->client_count_out = outlet_new(&m_x->x_obj, &s_float);
@@ -131,6 +144,11 @@ ParameterServer::ParameterServer(t_rabbit_server_pd* x, int argc, t_atom *argv)
 
 
     std::string rhl_uri;
+    std::string schema;
+    std::string state;
+    int max_queue = 0;
+    float max_rate = 0;
+    bool batch = false;
 
     // check arguments
     for (int i = 0; i < argc; ++i)
@@ -154,6 +172,70 @@ ParameterServer::ParameterServer(t_rabbit_server_pd* x, int argc, t_atom *argv)
             {
                 m_raw = true;
             }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@defer") == 0)
+            {
+                m_defer = true;
+            }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@lockstats") == 0)
+            {
+                setLockStats(true);
+            }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@schema") == 0 &&
+                     i < argc-1)
+            {
+                i++;
+                if (argv[i].a_type == A_SYMBOL)
+                {
+                    schema = std::string(argv[i].a_w.w_symbol->s_name);
+                }
+                else
+                {
+                    pd_error(m_x, "invalid schema file");
+                }
+            }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@state") == 0 &&
+                     i < argc-1)
+            {
+                i++;
+                if (argv[i].a_type == A_SYMBOL)
+                {
+                    state = std::string(argv[i].a_w.w_symbol->s_name);
+                }
+                else
+                {
+                    pd_error(m_x, "invalid state file");
+                }
+            }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@batch") == 0)
+            {
+                batch = true;
+            }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@maxqueue") == 0 &&
+                     i < argc-1)
+            {
+                i++;
+                if (canBeInt(argv[i]))
+                {
+                    max_queue = getInt(argv[i]);
+                }
+                else
+                {
+                    pd_error(m_x, "invalid maxqueue");
+                }
+            }
+            else if (strcmp(argv[i].a_w.w_symbol->s_name, "@maxrate") == 0 &&
+                     i < argc-1)
+            {
+                i++;
+                if (canBeFloat(argv[i]))
+                {
+                    max_rate = getAFloat(argv[i], 0);
+                }
+                else
+                {
+                    pd_error(m_x, "invalid maxrate");
+                }
+            }
 
             // other arguments?
         }
@@ -167,11 +249,11 @@ ParameterServer::ParameterServer(t_rabbit_server_pd* x, int argc, t_atom *argv)
 
         setRawOutlet(m_x->raw_out);
 
-        m_transporter = new PdServerTransporter((t_pd*)x);
+        m_transporter = new PdServerTransporter((t_pd*)x, m_mutex);
     }
     else
     {
-        m_transporter = new WebsocketServerTransporter((t_pd*)x);
+        m_transporter = new WebsocketServerTransporter((t_pd*)x, m_mutex);
     }
 
     if (!m_transporter)
@@ -179,18 +261,53 @@ ParameterServer::ParameterServer(t_rabbit_server_pd* x, int argc, t_atom *argv)
         throw std::runtime_error("could not create rcp server transporter");
     }
 
+    setMaxQueue(max_queue);
+    setMaxRate(max_rate);
+    setBatch(batch);
+
     // add transporter
     rcp_server_add_transporter(m_server, m_transporter->transporter());
 
 
+    if (!schema.empty())
+    {
+        loadSchema(schema);
+    }
+
+    // values of the state file win over schema values
+    if (!state.empty())
+    {
+        loadState(state);
+    }
+
     if (!rhl_uri.empty())
     {
         setRabbithole(rhl_uri);
     }
+
+    m_deferInfo = false;
+
+    if (!m_pendingInfo.empty() ||
+        !m_pendingValues.empty())
+    {
+        clock_delay(m_infoClock, 0);
+    }
 }
 
 ParameterServer::~ParameterServer()
 {
+    if (m_transactionClock)
+    {
+        clock_free(m_transactionClock);
+        m_transactionClock = nullptr;
+    }
+
+    if (m_infoClock)
+    {
+        clock_free(m_infoClock);
+        m_infoClock = nullptr;
+    }
+
     if (m_rabbitholeTransporter)
     {
         m_rabbitholeTransporter.reset();
@@ -226,12 +343,6 @@ ParameterServer::~ParameterServer()
     }
 }
 
-// NOTE: called from transporter thread
-void ParameterServer::outputIdParameterList(std::vector<t_atom>* list)
-{
-    pd_queue_mess(&pd_maininstance, (t_pd*)m_x, list, pd_id_parameter_output);
-}
-
 // port
 int ParameterServer::port() const
 {
@@ -290,53 +401,214 @@ size_t ParameterServer::clientCount() const
     return 0;
 }
 
-// parameter
-void ParameterServer::exposeParameter(int argc, t_atom* argv)
+void ParameterServer::setMaxQueue(int bytes)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    if (m_transporter)
+    {
+        m_transporter->setMaxQueue(bytes > 0 ? bytes : 0);
+    }
+}
 
-    // <type> <group> <group> ... <label>
-    // options: @min @max @readonly @order
+void ParameterServer::setMaxRate(float updatesPerSecond)
+{
+    if (m_transporter)
+    {
+        m_transporter->setMaxRate(updatesPerSecond);
+    }
+}
 
-    if (argc < 2)
+void ParameterServer::outputClientStats() const
+{
+    if (!m_transporter)
     {
-        pd_error(m_x, "not enough arguments to expose parameter");
         return;
     }
 
-    // check type
-    rcp_datatype datatype = DATATYPE_INVALID;
-    if (argv[0].a_type != A_SYMBOL)
+    std::vector<ClientQueueStats> stats;
+    m_transporter->clientQueueStats(stats);
+
+    for (size_t i=0; i<stats.size(); i++)
     {
-        pd_error(m_x, "please provide a valid type (f, i, t, b, s)");
+        // clientstats <client id> <queued packets> <queued bytes> <coalesced> <evicted>
+        t_atom list[5];
+        setInt(list[0], stats[i].id);
+        setFloat(list[1], stats[i].packets);
+        setFloat(list[2], stats[i].bytes);
+        setFloat(list[3], stats[i].coalesced);
+        setInt(list[4], stats[i].evicted ? 1 : 0);
+
+        outlet_anything(m_x->info_out, gensym("clientstats"), 5, list);
+    }
+}
+
+void ParameterServer::setBatch(bool batch)
+{
+    if (m_transporter)
+    {
+        m_transporter->setBatch(batch);
+    }
+}
+
+void ParameterServer::outputSendStats() const
+{
+    uint32_t packets = 0;
+    uint32_t frames = 0;
+    uint32_t buffers = 0;
+
+    if (m_transporter)
+    {
+        m_transporter->sendStats(packets, frames, buffers);
+    }
+
+    // sendstats <packets> <frames> <buffers allocated>
+    t_atom list[3];
+    setFloat(list[0], packets);
+    setFloat(list[1], frames);
+    setFloat(list[2], buffers);
+
+    outlet_anything(m_x->info_out, gensym("sendstats"), 3, list);
+}
+
+void ParameterServer::outputRawStats() const
+{
+    if (m_raw &&
+        m_transporter)
+    {
+        static_cast<PdServerTransporter*>(m_transporter)->outputStats(m_x->info_out);
+    }
+}
+
+void ParameterServer::begin()
+{
+    Threading::Lock lock(m_mutex);
+
+    m_transaction++;
+
+    if (m_transaction == 1)
+    {
+        clock_delay(m_transactionClock, RCP_TRANSACTION_TIMEOUT_MS);
+    }
+    else if (m_transaction == RCP_TRANSACTION_WARN_DEPTH)
+    {
+        pd_error(m_x, "begin: %d nested transactions - missing commit? nothing is sent until all are committed", m_transaction);
+    }
+}
+
+void ParameterServer::commit(bool all)
+{
+    Threading::Lock lock(m_mutex);
+
+    if (m_transaction == 0)
+    {
+        if (!all)
+        {
+            pd_error(m_x, "commit without begin");
+        }
         return;
     }
 
-    //
-    const char* type_str = argv[0].a_w.w_symbol->s_name;
+    if (all)
+    {
+        m_transaction = 0;
+    }
+    else
+    {
+        m_transaction--;
+    }
 
-    if (*type_str == 'f' || *type_str == 'F')
+    if (m_transaction == 0)
     {
-        // TODO check pd/max float size!
-        datatype = DATATYPE_FLOAT32;
+        clock_unset(m_transactionClock);
+
+        if (m_transactionDirty)
+        {
+            m_transactionDirty = false;
+            rcp_server_update(m_server);
+        }
     }
-    else if (*type_str == 'i' || *type_str == 'I')
+}
+
+int ParameterServer::transactionDepth() const
+{
+    Threading::Lock lock(m_mutex);
+
+    return m_transaction;
+}
+
+void ParameterServer::transactionTimeout()
+{
+    int depth = transactionDepth();
+
+    if (depth > 0)
     {
-        datatype = DATATYPE_INT32;
+        pd_error(m_x, "transaction open for %d ms (depth %d) - nothing is sent until commit, \"commit all\" closes it",
+                 RCP_TRANSACTION_TIMEOUT_MS,
+                 depth);
     }
-    else if (*type_str == 't' || *type_str == 'T')
+}
+
+void ParameterServer::outputInfo(t_symbol* selector, int argc, t_atom* argv)
+{
+    if (m_deferInfo)
     {
-        datatype = DATATYPE_BOOLEAN;
+        m_pendingInfo.push_back(std::make_pair(selector, std::vector<t_atom>(argv, argv + argc)));
+        return;
     }
-    else if (*type_str == 'b' || *type_str == 'B')
+
+    outlet_anything(m_x->info_out, selector, argc, argv);
+}
+
+void ParameterServer::outputPendingInfo()
+{
+    std::vector<int16_t> values;
+    values.swap(m_pendingValues);
+    outputParameters(values);
+
+    std::vector<std::pair<t_symbol*, std::vector<t_atom> > > pending;
+    pending.swap(m_pendingInfo);
+
+    for (size_t i=0; i<pending.size(); i++)
     {
-        datatype = DATATYPE_BANG;
+        outlet_anything(m_x->info_out, pending[i].first, (int)pending[i].second.size(), pending[i].second.data());
     }
-    else if (*type_str == 's' || *type_str == 'S')
+}
+
+void ParameterServer::serverUpdate()
+{
+    if (m_transaction > 0)
+    {
+        // sent on commit
+        m_transactionDirty = true;
+        return;
+    }
+
+    rcp_server_update(m_server);
+}
+
+// parameter
+void ParameterServer::exposeParameter(int argc, t_atom* argv)
+{
+    Threading::TimedLock lock(m_mutex, LOCK_SITE_EXPOSE);
+
+    // <type> <group> <group> ... <label>
+    // options: @min @max @readonly @order
+
+    if (argc < 2)
+    {
+        pd_error(m_x, "not enough arguments to expose parameter");
+        return;
+    }
+
+    // check type
+    rcp_datatype datatype = DATATYPE_INVALID;
+    if (argv[0].a_type != A_SYMBOL)
     {
-        datatype = DATATYPE_STRING;
+        pd_error(m_x, "please provide a valid type (f, i, t, b, s)");
+        return;
     }
 
+    const char* type_str = argv[0].a_w.w_symbol->s_name;
+    datatype = parseDatatype(type_str);
 
     // check datatype
     if (datatype == DATATYPE_INVALID)
@@ -429,61 +701,784 @@ void ParameterServer::exposeParameter(int argc, t_atom* argv)
         return;
     }
 
-    // check if this label already exists in group
-    rcp_parameter* param = rcp_manager_find_parameter(m_manager, label.c_str(), group);
-    if (param != NULL)
+    createParameter(datatype, label.c_str(), group, min, max, readonly, order);
+
+    serverUpdate();
+}
+
+
+void ParameterServer::loadSchema(const std::string& filename)
+{
+    double start = sys_getrealtime();
+
+    // read and parse without the lock
+    SchemaLoader schema;
+    if (!schema.load(resolvePath(filename)))
     {
-        pd_error(m_x, "parameter '%s' already exists", label.c_str());
+        pd_error(m_x, "loadschema: %s", schema.error().c_str());
         return;
     }
 
+    size_t created = 0;
 
-    // expose parameter
-    switch (datatype)
-    {
-    case DATATYPE_FLOAT32:
     {
-        rcp_value_parameter* p = rcp_server_expose_f32(m_server, label.c_str(), group);
-        setupValueParameter(p);
-        if (p != NULL)
-        {
-            if (min.isSet()) rcp_parameter_set_min_float(p, min.get());
-            if (max.isSet()) rcp_parameter_set_max_float(p, max.get());
-            if (order.isSet()) rcp_parameter_set_order(RCP_PARAMETER(p), order.get());
-            if (readonly.isSet()) rcp_parameter_set_readonly(RCP_PARAMETER(p), readonly.get());
+        Threading::TimedLock lock(m_mutex, LOCK_SITE_EXPOSE);
 
-            // set default value
-            rcp_parameter_set_value_float(p, 0);
-        }
-        else
-        {
-            pd_error(m_x, "could not create parameter");
-        }
-        break;
+        created = createSchemaNodes(schema.nodes(), NULL);
+
+        serverUpdate();
     }
-    case DATATYPE_INT32:
+
+    double ms = (sys_getrealtime() - start) * 1000.;
+
+    // schema <parameters created> <milliseconds>
+    t_atom list[2];
+    setFloat(list[0], created);
+    setFloat(list[1], ms);
+
+    outputInfo(gensym("schema"), 2, list);
+}
+
+void ParameterServer::saveState(const std::string& filename)
+{
+    double start = sys_getrealtime();
+
+    ParameterState state;
+    std::vector<StateRecord>& records = state.records();
+
     {
-        rcp_value_parameter* p = rcp_server_expose_i32(m_server, label.c_str(), group);
-        setupValueParameter(p);
-        if (p != NULL)
+        Threading::Lock lock(m_mutex);
+
+        // parents first: sort by depth
+        std::vector<std::pair<size_t, rcp_parameter*> > parameters;
+
+        rcp_parameter_list* list = rcp_manager_get_paramter_list(m_manager);
+        while (list != NULL)
         {
-            if (min.isSet()) rcp_parameter_set_min_int32(p, (int32_t)min.get());
-            if (max.isSet()) rcp_parameter_set_max_int32(p, (int32_t)max.get());
-            if (order.isSet()) rcp_parameter_set_order(RCP_PARAMETER(p), order.get());
-            if (readonly.isSet()) rcp_parameter_set_readonly(RCP_PARAMETER(p), readonly.get());
+            size_t depth = 0;
+            rcp_group_parameter* parent = rcp_parameter_get_parent(list->parameter);
+            while (parent != NULL)
+            {
+                depth++;
+                parent = rcp_parameter_get_parent(RCP_PARAMETER(parent));
+            }
 
-            // set default value
-            rcp_parameter_set_value_int32(p, 0);
+            parameters.push_back(std::make_pair(depth, list->parameter));
+            list = list->next;
         }
-        else
+
+        std::stable_sort(parameters.begin(), parameters.end(),
+                         [](const std::pair<size_t, rcp_parameter*>& a,
+                            const std::pair<size_t, rcp_parameter*>& b)
         {
-            pd_error(m_x, "could not create parameter");
-        }
-        break;
-    }
-    case DATATYPE_BOOLEAN:
+            return a.first < b.first;
+        });
+
+        std::unordered_map<rcp_parameter*, int32_t> indices;
+        records.resize(parameters.size());
+
+        for (size_t i=0; i<parameters.size(); i++)
+        {
+            rcp_parameter* parameter = parameters[i].second;
+            StateRecord& r = records[i];
+
+            indices[parameter] = (int32_t)i;
+
+            rcp_datatype type = RCP_TYPE_ID(parameter);
+            const char* label = rcp_parameter_get_label(parameter);
+
+            r.type = (uint8_t)type;
+            r.label = label != NULL ? label : "";
+
+            rcp_group_parameter* parent = rcp_parameter_get_parent(parameter);
+            if (parent != NULL)
+            {
+                std::unordered_map<rcp_parameter*, int32_t>::const_iterator it = indices.find(RCP_PARAMETER(parent));
+                r.parent = it != indices.end() ? it->second : -1;
+            }
+
+            if (rcp_parameter_get_readonly(parameter)) r.flags |= StateRecord::READONLY;
+
+            r.flags |= StateRecord::ORDER;
+            r.order = rcp_parameter_get_order(parameter);
+
+            rcp_typedefinition* td = rcp_parameter_get_typedefinition(parameter);
+            rcp_value_parameter* p = RCP_VALUE_PARAMETER(parameter);
+
+            switch (type)
+            {
+            case DATATYPE_FLOAT32:
+                if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MINIMUM))
+                {
+                    r.flags |= StateRecord::MIN;
+                    r.min.f = rcp_parameter_get_min_float(p);
+                }
+                if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MAXIMUM))
+                {
+                    r.flags |= StateRecord::MAX;
+                    r.max.f = rcp_parameter_get_max_float(p);
+                }
+                r.flags |= StateRecord::VALUE;
+                r.number.f = rcp_parameter_get_value_float(p);
+                break;
+            case DATATYPE_INT32:
+                if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MINIMUM))
+                {
+                    r.flags |= StateRecord::MIN;
+                    r.min.i = rcp_parameter_get_min_int32(p);
+                }
+                if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MAXIMUM))
+                {
+                    r.flags |= StateRecord::MAX;
+                    r.max.i = rcp_parameter_get_max_int32(p);
+                }
+                r.flags |= StateRecord::VALUE;
+                r.number.i = rcp_parameter_get_value_int32(p);
+                break;
+            case DATATYPE_BOOLEAN:
+                r.flags |= StateRecord::VALUE;
+                r.boolean = rcp_parameter_get_value_bool(p);
+                break;
+            case DATATYPE_STRING:
+            {
+                const char* value = rcp_parameter_get_value_string(p);
+                r.flags |= StateRecord::VALUE;
+                r.string = value != NULL ? value : "";
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    // write without the lock
+    if (!state.write(resolvePath(filename)))
     {
-        rcp_value_parameter* p = rcp_server_expose_bool(m_server, label.c_str(), group);
+        pd_error(m_x, "savestate: %s", state.error().c_str());
+        return;
+    }
+
+    double ms = (sys_getrealtime() - start) * 1000.;
+
+    // savestate <parameters> <milliseconds>
+    t_atom list[2];
+    setFloat(list[0], records.size());
+    setFloat(list[1], ms);
+
+    outlet_anything(m_x->info_out, gensym("savestate"), 2, list);
+}
+
+void ParameterServer::loadState(const std::string& filename)
+{
+    double start = sys_getrealtime();
+
+    // read and decode without the lock
+    ParameterState state;
+    if (!state.read(resolvePath(filename)))
+    {
+        pd_error(m_x, "loadstate: %s", state.error().c_str());
+        return;
+    }
+
+    const std::vector<StateRecord>& records = state.records();
+    size_t restored = 0;
+
+    // ids of restored values - output after the lock is released
+    std::vector<int16_t> values;
+
+    {
+        Threading::TimedLock lock(m_mutex, LOCK_SITE_EXPOSE);
+
+        // created or found parameter per record
+        std::vector<rcp_parameter*> parameters(records.size(), NULL);
+
+        for (size_t i=0; i<records.size(); i++)
+        {
+            const StateRecord& r = records[i];
+            rcp_datatype type = (rcp_datatype)r.type;
+
+            rcp_group_parameter* group = NULL;
+            if (r.parent >= 0)
+            {
+                group = RCP_GROUP_PARAMETER(parameters[r.parent]);
+                if (group == NULL)
+                {
+                    // parent failed
+                    continue;
+                }
+            }
+
+            if (type == DATATYPE_GROUP)
+            {
+                parameters[i] = RCP_PARAMETER(findOrCreateGroup(gensym(r.label.c_str()), group));
+                continue;
+            }
+
+            // an existing parameter of the same type is restored in place
+            rcp_parameter* parameter = findParameter(gensym(r.label.c_str()), group);
+            if (parameter != NULL &&
+                RCP_TYPE_ID(parameter) != type)
+            {
+                pd_error(m_x, "loadstate: '%s' exists with another type", r.label.c_str());
+                continue;
+            }
+
+            Optional<float> none;
+            Optional<bool> readonly;
+            Optional<int> order;
+            if (r.flags & StateRecord::READONLY) readonly.set(true);
+            if (r.flags & StateRecord::ORDER) order.set(r.order);
+
+            if (parameter == NULL)
+            {
+                parameter = createParameter(type, r.label.c_str(), group, none, none, readonly, order);
+                if (parameter == NULL)
+                {
+                    continue;
+                }
+
+                m_adoptable.insert(rcp_parameter_get_id(parameter));
+            }
+            else
+            {
+                // only changed options are sent
+                bool ro = (r.flags & StateRecord::READONLY) != 0;
+                if (rcp_parameter_get_readonly(parameter) != ro) rcp_parameter_set_readonly(parameter, ro);
+                if (order.isSet() &&
+                    rcp_parameter_get_order(parameter) != order.get())
+                {
+                    rcp_parameter_set_order(parameter, order.get());
+                }
+            }
+
+            parameters[i] = parameter;
+            restored++;
+
+            rcp_value_parameter* p = RCP_VALUE_PARAMETER(parameter);
+
+            switch (type)
+            {
+            case DATATYPE_FLOAT32:
+                if (r.flags & StateRecord::MIN) rcp_parameter_set_min_float(p, r.min.f);
+                if (r.flags & StateRecord::MAX) rcp_parameter_set_max_float(p, r.max.f);
+                if (r.flags & StateRecord::VALUE) rcp_parameter_set_value_float(p, r.number.f);
+                break;
+            case DATATYPE_INT32:
+                if (r.flags & StateRecord::MIN) rcp_parameter_set_min_int32(p, r.min.i);
+                if (r.flags & StateRecord::MAX) rcp_parameter_set_max_int32(p, r.max.i);
+                if (r.flags & StateRecord::VALUE) rcp_parameter_set_value_int32(p, r.number.i);
+                break;
+            case DATATYPE_BOOLEAN:
+                if (r.flags & StateRecord::VALUE) rcp_parameter_set_value_bool(p, r.boolean);
+                break;
+            case DATATYPE_STRING:
+                if (r.flags & StateRecord::VALUE) rcp_parameter_set_value_string(p, r.string.c_str());
+                break;
+            default:
+                break;
+            }
+
+            if ((r.flags & StateRecord::VALUE) &&
+                type != DATATYPE_BANG)
+            {
+                values.push_back(rcp_parameter_get_id(parameter));
+            }
+        }
+
+        serverUpdate();
+    }
+
+    // the patch learns the restored values like client changes
+    if (m_deferInfo)
+    {
+        m_pendingValues.insert(m_pendingValues.end(), values.begin(), values.end());
+    }
+    else
+    {
+        outputParameters(values);
+    }
+
+    double ms = (sys_getrealtime() - start) * 1000.;
+
+    // loadstate <parameters restored> <milliseconds>
+    t_atom list[2];
+    setFloat(list[0], restored);
+    setFloat(list[1], ms);
+
+    outputInfo(gensym("loadstate"), 2, list);
+}
+
+void ParameterServer::preset(int argc, t_atom* argv)
+{
+    // preset store <name>
+    // preset recall <name>
+    // preset interpolate <a> <b> <t>
+    // preset remove <name>
+
+    if (argc < 2 ||
+        argv[0].a_type != A_SYMBOL ||
+        argv[1].a_type != A_SYMBOL)
+    {
+        pd_error(m_x, "preset: expected <store|recall|interpolate|remove> <name>");
+        return;
+    }
+
+    static t_symbol* s_store = gensym("store");
+    static t_symbol* s_recall = gensym("recall");
+    static t_symbol* s_interpolate = gensym("interpolate");
+    static t_symbol* s_remove = gensym("remove");
+
+    t_symbol* command = argv[0].a_w.w_symbol;
+    t_symbol* name = argv[1].a_w.w_symbol;
+
+    if (command == s_store)
+    {
+        storePreset(name);
+    }
+    else if (command == s_recall)
+    {
+        recallPreset(name);
+    }
+    else if (command == s_interpolate)
+    {
+        if (argc < 4 ||
+            argv[2].a_type != A_SYMBOL ||
+            !canBeFloat(argv[3]))
+        {
+            pd_error(m_x, "preset: expected interpolate <a> <b> <t>");
+            return;
+        }
+
+        interpolatePreset(name, argv[2].a_w.w_symbol, getAFloat(argv[3], 0));
+    }
+    else if (command == s_remove)
+    {
+        m_presets.erase(name);
+    }
+    else
+    {
+        pd_error(m_x, "preset: unknown command: %s", command->s_name);
+    }
+}
+
+void ParameterServer::storePreset(t_symbol* name)
+{
+    Preset& preset = m_presets[name];
+    preset.values.clear();
+    preset.strings.clear();
+
+    Threading::Lock lock(m_mutex);
+
+    rcp_parameter_list* list = rcp_manager_get_paramter_list(m_manager);
+    while (list != NULL)
+    {
+        rcp_parameter* parameter = list->parameter;
+        list = list->next;
+
+        // readonly parameter show values of the patch
+        if (!rcp_parameter_is_value(parameter) ||
+            rcp_parameter_get_readonly(parameter))
+        {
+            continue;
+        }
+
+        rcp_value_parameter* p = RCP_VALUE_PARAMETER(parameter);
+
+        PresetValue value;
+        value.id = rcp_parameter_get_id(parameter);
+        value.type = (uint8_t)RCP_TYPE_ID(parameter);
+        value.number.i = 0;
+
+        switch (value.type)
+        {
+        case DATATYPE_FLOAT32:
+            value.number.f = rcp_parameter_get_value_float(p);
+            break;
+        case DATATYPE_INT32:
+            value.number.i = rcp_parameter_get_value_int32(p);
+            break;
+        case DATATYPE_BOOLEAN:
+            value.number.i = rcp_parameter_get_value_bool(p) ? 1 : 0;
+            break;
+        case DATATYPE_STRING:
+        {
+            const char* string = rcp_parameter_get_value_string(p);
+            value.number.i = (int32_t)preset.strings.size();
+            preset.strings.push_back(string != NULL ? string : "");
+            break;
+        }
+        default:
+            continue;
+        }
+
+        preset.values.push_back(value);
+    }
+
+    std::sort(preset.values.begin(), preset.values.end(),
+              [](const PresetValue& a, const PresetValue& b)
+    {
+        return a.id < b.id;
+    });
+}
+
+void ParameterServer::recallPreset(t_symbol* name)
+{
+    std::unordered_map<t_symbol*, Preset>::const_iterator it = m_presets.find(name);
+    if (it == m_presets.end())
+    {
+        pd_error(m_x, "preset not found: %s", name->s_name);
+        return;
+    }
+
+    const Preset& preset = it->second;
+
+    // ids of changed values - output after the lock is released
+    std::vector<int16_t> changed;
+
+    {
+        Threading::TimedLock lock(m_mutex, LOCK_SITE_LIST);
+
+        for (size_t i=0; i<preset.values.size(); i++)
+        {
+            if (applyPresetValue(preset.values[i], preset.strings))
+            {
+                changed.push_back(preset.values[i].id);
+            }
+        }
+
+        if (!changed.empty())
+        {
+            updateManager();
+        }
+    }
+
+    // the patch learns every changed value, plus one notification
+    outputParameters(changed);
+
+    t_atom list[2];
+    setSymbol(list[0], gensym("recalled"));
+    setSymbol(list[1], name);
+    outlet_anything(m_infoOutlet, gensym("preset"), 2, list);
+}
+
+void ParameterServer::interpolatePreset(t_symbol* nameA, t_symbol* nameB, float t)
+{
+    std::unordered_map<t_symbol*, Preset>::const_iterator it_a = m_presets.find(nameA);
+    std::unordered_map<t_symbol*, Preset>::const_iterator it_b = m_presets.find(nameB);
+
+    if (it_a == m_presets.end() ||
+        it_b == m_presets.end())
+    {
+        pd_error(m_x, "preset not found: %s", (it_a == m_presets.end() ? nameA : nameB)->s_name);
+        return;
+    }
+
+    const Preset& a = it_a->second;
+    const Preset& b = it_b->second;
+
+    t = std::max(0.f, std::min(1.f, t));
+
+    std::vector<int16_t> changed;
+
+    {
+        Threading::TimedLock lock(m_mutex, LOCK_SITE_LIST);
+
+        // both sorted by id: walk them together, parameters in both presets only
+        size_t i = 0;
+        size_t j = 0;
+
+        while (i < a.values.size() &&
+               j < b.values.size())
+        {
+            const PresetValue& va = a.values[i];
+            const PresetValue& vb = b.values[j];
+
+            if (va.id < vb.id)
+            {
+                i++;
+                continue;
+            }
+
+            if (vb.id < va.id)
+            {
+                j++;
+                continue;
+            }
+
+            i++;
+            j++;
+
+            if (va.type != vb.type)
+            {
+                continue;
+            }
+
+            PresetValue value = va;
+
+            switch (va.type)
+            {
+            case DATATYPE_FLOAT32:
+                value.number.f = va.number.f + (vb.number.f - va.number.f) * t;
+                if (applyPresetValue(value, a.strings)) changed.push_back(value.id);
+                break;
+            case DATATYPE_INT32:
+                // difference in double: b - a overflows int32 for wide ranges
+                value.number.i = (int32_t)lround(va.number.i + ((double)vb.number.i - (double)va.number.i) * t);
+                if (applyPresetValue(value, a.strings)) changed.push_back(value.id);
+                break;
+            default:
+                // switch in the middle
+                if (t < 0.5f ?
+                    applyPresetValue(va, a.strings) :
+                    applyPresetValue(vb, b.strings))
+                {
+                    changed.push_back(va.id);
+                }
+                break;
+            }
+        }
+
+        if (!changed.empty())
+        {
+            updateManager();
+        }
+    }
+
+    outputParameters(changed);
+
+    t_atom list[4];
+    setSymbol(list[0], gensym("interpolated"));
+    setSymbol(list[1], nameA);
+    setSymbol(list[2], nameB);
+    setFloat(list[3], t);
+    outlet_anything(m_infoOutlet, gensym("preset"), 4, list);
+}
+
+void ParameterServer::outputParameters(const std::vector<int16_t>& ids)
+{
+    // one short lock per value: the I/O thread can get in between
+    for (size_t i=0; i<ids.size(); i++)
+    {
+        Threading::Lock lock(m_mutex);
+
+        rcp_parameter* parameter = findParameter(ids[i]);
+        if (parameter != NULL)
+        {
+            parameterUpdate(parameter);
+        }
+    }
+}
+
+bool ParameterServer::applyPresetValue(const PresetValue& value, const std::vector<std::string>& strings)
+{
+    rcp_parameter* parameter = findParameter(value.id);
+
+    // gone, replaced or readonly by now
+    if (parameter == NULL ||
+        RCP_TYPE_ID(parameter) != value.type ||
+        rcp_parameter_get_readonly(parameter))
+    {
+        return false;
+    }
+
+    rcp_value_parameter* p = RCP_VALUE_PARAMETER(parameter);
+
+    switch (value.type)
+    {
+    case DATATYPE_FLOAT32:
+        if (rcp_parameter_get_value_float(p) == value.number.f) return false;
+        rcp_parameter_set_value_float(p, value.number.f);
+        break;
+    case DATATYPE_INT32:
+        if (rcp_parameter_get_value_int32(p) == value.number.i) return false;
+        rcp_parameter_set_value_int32(p, value.number.i);
+        break;
+    case DATATYPE_BOOLEAN:
+        if (rcp_parameter_get_value_bool(p) == (value.number.i != 0)) return false;
+        rcp_parameter_set_value_bool(p, value.number.i != 0);
+        break;
+    case DATATYPE_STRING:
+    {
+        const std::string& string = strings[value.number.i];
+        const char* current = rcp_parameter_get_value_string(p);
+        if (current != NULL && string == current) return false;
+        rcp_parameter_set_value_string(p, string.c_str());
+        break;
+    }
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+std::string ParameterServer::resolvePath(const std::string& filename) const
+{
+    // relative to the patch
+    if (!sys_isabsolutepath(filename.c_str()) &&
+        m_dir != nullptr)
+    {
+        return std::string(m_dir->s_name) + "/" + filename;
+    }
+
+    return filename;
+}
+
+size_t ParameterServer::createSchemaNodes(const std::vector<SchemaNode>& nodes, rcp_group_parameter* group)
+{
+    size_t created = 0;
+
+    for (size_t i=0; i<nodes.size(); i++)
+    {
+        const SchemaNode& node = nodes[i];
+
+        if (node.isGroup())
+        {
+            rcp_group_parameter* child = findOrCreateGroup(gensym(node.label.c_str()), group);
+            if (child == nullptr)
+            {
+                pd_error(m_x, "loadschema: could not create group '%s'", node.label.c_str());
+                continue;
+            }
+
+            created += createSchemaNodes(node.children, child);
+            continue;
+        }
+
+        rcp_datatype datatype = parseDatatype(node.type.c_str());
+        if (datatype == DATATYPE_INVALID)
+        {
+            pd_error(m_x, "loadschema: unknown datatype '%s' of '%s'", node.type.c_str(), node.label.c_str());
+            continue;
+        }
+
+        rcp_parameter* parameter = createParameter(datatype,
+                                                   node.label.c_str(),
+                                                   group,
+                                                   node.min,
+                                                   node.max,
+                                                   node.readonly,
+                                                   node.order);
+        if (parameter == NULL)
+        {
+            continue;
+        }
+
+        created++;
+        m_adoptable.insert(rcp_parameter_get_id(parameter));
+
+        // initial value
+        rcp_value_parameter* p = RCP_VALUE_PARAMETER(parameter);
+        switch (datatype)
+        {
+        case DATATYPE_FLOAT32:
+            // out of range casts are undefined - clamp first
+            if (node.number.isSet()) rcp_parameter_set_value_float(p, (float)clampNumber(node.number.get(), -FLT_MAX, FLT_MAX));
+            break;
+        case DATATYPE_INT32:
+            if (node.number.isSet()) rcp_parameter_set_value_int32(p, (int32_t)clampNumber(node.number.get(), INT32_MIN, INT32_MAX));
+            break;
+        case DATATYPE_BOOLEAN:
+            if (node.number.isSet()) rcp_parameter_set_value_bool(p, node.number.get() != 0);
+            break;
+        case DATATYPE_STRING:
+            if (node.string.isSet()) rcp_parameter_set_value_string(p, node.string.get().c_str());
+            break;
+        default:
+            break;
+        }
+    }
+
+    return created;
+}
+
+rcp_parameter* ParameterServer::createParameter(rcp_datatype datatype,
+                                                const char* label,
+                                                rcp_group_parameter* group,
+                                                const Optional<float>& min,
+                                                const Optional<float>& max,
+                                                const Optional<bool>& readonly,
+                                                const Optional<int>& order)
+{
+    // check if this label already exists in group
+    rcp_parameter* param = findParameter(gensym(label), group);
+    if (param != NULL)
+    {
+        std::unordered_set<int16_t>::iterator it = m_adoptable.find(rcp_parameter_get_id(param));
+        if (it != m_adoptable.end() &&
+            RCP_TYPE_ID(param) == datatype)
+        {
+            // created by @schema or @state: the patch's own expose takes it over, its value is kept
+            m_adoptable.erase(it);
+
+            if (datatype == DATATYPE_FLOAT32)
+            {
+                if (min.isSet()) rcp_parameter_set_min_float(RCP_VALUE_PARAMETER(param), min.get());
+                if (max.isSet()) rcp_parameter_set_max_float(RCP_VALUE_PARAMETER(param), max.get());
+            }
+            else if (datatype == DATATYPE_INT32)
+            {
+                if (min.isSet()) rcp_parameter_set_min_int32(RCP_VALUE_PARAMETER(param), (int32_t)min.get());
+                if (max.isSet()) rcp_parameter_set_max_int32(RCP_VALUE_PARAMETER(param), (int32_t)max.get());
+            }
+            if (order.isSet()) rcp_parameter_set_order(param, order.get());
+            if (readonly.isSet()) rcp_parameter_set_readonly(param, readonly.get());
+
+            return param;
+        }
+
+        pd_error(m_x, "parameter '%s' already exists", label);
+        return NULL;
+    }
+
+
+    // expose parameter
+    switch (datatype)
+    {
+    case DATATYPE_FLOAT32:
+    {
+        rcp_value_parameter* p = rcp_server_expose_f32(m_server, label, group);
+        setupValueParameter(p);
+        if (p != NULL)
+        {
+            if (min.isSet()) rcp_parameter_set_min_float(p, min.get());
+            if (max.isSet()) rcp_parameter_set_max_float(p, max.get());
+            if (order.isSet()) rcp_parameter_set_order(RCP_PARAMETER(p), order.get());
+            if (readonly.isSet()) rcp_parameter_set_readonly(RCP_PARAMETER(p), readonly.get());
+
+            // set default value
+            rcp_parameter_set_value_float(p, 0);
+        }
+        else
+        {
+            pd_error(m_x, "could not create parameter");
+        }
+        return RCP_PARAMETER(p);
+    }
+    case DATATYPE_INT32:
+    {
+        rcp_value_parameter* p = rcp_server_expose_i32(m_server, label, group);
+        setupValueParameter(p);
+        if (p != NULL)
+        {
+            if (min.isSet()) rcp_parameter_set_min_int32(p, (int32_t)min.get());
+            if (max.isSet()) rcp_parameter_set_max_int32(p, (int32_t)max.get());
+            if (order.isSet()) rcp_parameter_set_order(RCP_PARAMETER(p), order.get());
+            if (readonly.isSet()) rcp_parameter_set_readonly(RCP_PARAMETER(p), readonly.get());
+
+            // set default value
+            rcp_parameter_set_value_int32(p, 0);
+        }
+        else
+        {
+            pd_error(m_x, "could not create parameter");
+        }
+        return RCP_PARAMETER(p);
+    }
+    case DATATYPE_BOOLEAN:
+    {
+        rcp_value_parameter* p = rcp_server_expose_bool(m_server, label, group);
         setupValueParameter(p);
         if (p != NULL)
         {
@@ -497,11 +1492,11 @@ void ParameterServer::exposeParameter(int argc, t_atom* argv)
         {
             pd_error(m_x, "could not create parameter");
         }
-        break;
+        return RCP_PARAMETER(p);
     }
     case DATATYPE_STRING:
     {
-        rcp_value_parameter* p = rcp_server_expose_string(m_server, label.c_str(), group);
+        rcp_value_parameter* p = rcp_server_expose_string(m_server, label, group);
         setupValueParameter(p);
         if (p != NULL)
         {
@@ -515,11 +1510,11 @@ void ParameterServer::exposeParameter(int argc, t_atom* argv)
         {
             pd_error(m_x, "could not create parameter");
         }
-        break;
+        return RCP_PARAMETER(p);
     }
     case DATATYPE_BANG:
     {
-        rcp_bang_parameter* p = rcp_server_expose_bang(m_server, label.c_str(), group);
+        rcp_bang_parameter* p = rcp_server_expose_bang(m_server, label, group);
         if (p != NULL)
         {
             if (order.isSet()) rcp_parameter_set_order(RCP_PARAMETER(p), order.get());
@@ -527,18 +1522,46 @@ void ParameterServer::exposeParameter(int argc, t_atom* argv)
 
             rcp_parameter_set_user(RCP_PARAMETER(p), this);
             rcp_bang_parameter_set_bang_cb(p, bangCb);
+
+            index().add(RCP_PARAMETER(p));
         }
         else
         {
             pd_error(m_x, "could not create parameter");
         }
-        break;
+        return RCP_PARAMETER(p);
     }
     }
 
-    rcp_server_update(m_server);
+    return NULL;
 }
 
+rcp_datatype ParameterServer::parseDatatype(const char* type_str)
+{
+    if (*type_str == 'f' || *type_str == 'F')
+    {
+        // TODO check pd/max float size!
+        return DATATYPE_FLOAT32;
+    }
+    else if (*type_str == 'i' || *type_str == 'I')
+    {
+        return DATATYPE_INT32;
+    }
+    else if (*type_str == 't' || *type_str == 'T')
+    {
+        return DATATYPE_BOOLEAN;
+    }
+    else if (*type_str == 'b' || *type_str == 'B')
+    {
+        return DATATYPE_BANG;
+    }
+    else if (*type_str == 's' || *type_str == 'S')
+    {
+        return DATATYPE_STRING;
+    }
+
+    return DATATYPE_INVALID;
+}
 
 rcp_group_parameter* ParameterServer::createGroups(int argc, t_atom* argv, std::string& outLabel)
 {
@@ -553,44 +1576,72 @@ rcp_group_parameter* ParameterServer::createGroups(int argc, t_atom* argv, std::
             return nullptr;
         }
 
-        std::string group_name = GetAsString(argv[i]);
-        rcp_group_parameter* group = rcp_server_find_group(m_server, group_name.c_str(), lastGroup);
-
-        if (group == nullptr)
-        {
-            // create group
-            group = rcp_server_create_group(m_server, group_name.c_str(), lastGroup);
-        }
-
-        lastGroup = group;
+        lastGroup = findOrCreateGroup(argv[i].a_w.w_symbol, lastGroup);
     }
 
     outLabel = GetAsString(argv[argc-1]);
     return lastGroup;
 }
 
+rcp_group_parameter* ParameterServer::findOrCreateGroup(t_symbol* name, rcp_group_parameter* parent)
+{
+    rcp_parameter* param = index().find(parent, name);
+    if (param != NULL &&
+        rcp_parameter_is_group(param) &&
+        rcp_parameter_get_parent(param) == parent &&
+        rcp_parameter_get_label(param) != NULL &&
+        strcmp(rcp_parameter_get_label(param), name->s_name) == 0)
+    {
+        return RCP_GROUP_PARAMETER(param);
+    }
+
+    // a miss in a complete index is final - search rcp only otherwise
+    rcp_group_parameter* group = nullptr;
+    if (!m_indexComplete)
+    {
+        group = rcp_server_find_group(m_server, name->s_name, parent);
+    }
+
+    if (group == nullptr)
+    {
+        // create group
+        group = rcp_server_create_group(m_server, name->s_name, parent);
+        index().add(RCP_PARAMETER(group));
+    }
+
+    return group;
+}
+
 void ParameterServer::setupValueParameter(rcp_value_parameter* parameter)
 {
     if (parameter)
     {
         rcp_parameter_set_user(RCP_PARAMETER(parameter), this);
         rcp_parameter_set_value_updated_cb(parameter, parameterValueUpdatedCb);
+
+        index().add(RCP_PARAMETER(parameter));
     }
 }
 
 void ParameterServer::removeParameter(int id)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
+
+    rcp_parameter* parameter = findParameter(id);
 
     if (rcp_server_remove_parameter_id(m_server, id))
     {
-        rcp_server_update(m_server);
+        m_adoptable.erase(id);
+
+        // the index does not touch the freed parameter
+        index().remove(parameter);
+        serverUpdate();
     }
 }
 
 void ParameterServer::removeParameterList(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
 
     rcp_parameter* param = getParameter(argc, argv);
     if (param)
@@ -601,7 +1652,7 @@ void ParameterServer::removeParameterList(int argc, t_atom* argv)
 
 void ParameterServer::parameterSetReadonly(int argc, t_atom* argv)
 {    
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
 
     if (!canBeInt(argv[argc-1]))
     {
@@ -613,13 +1664,13 @@ void ParameterServer::parameterSetReadonly(int argc, t_atom* argv)
     if (parameter)
     {
         rcp_parameter_set_readonly(parameter, getInt(argv[argc-1]) > 0);
-        rcp_server_update(m_server);
+        serverUpdate();
     }
 }
 
 void ParameterServer::parameterSetOrder(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
 
     if (!canBeInt(argv[argc-1]))
     {
@@ -631,13 +1682,13 @@ void ParameterServer::parameterSetOrder(int argc, t_atom* argv)
     if (parameter)
     {
         rcp_parameter_set_order(parameter, getInt(argv[argc-1]));
-        rcp_server_update(m_server);
+        serverUpdate();
     }
 }
 
 void ParameterServer::parameterSetMin(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
 
     rcp_parameter* parameter = getParameter(argc-1, argv);
     if (parameter)
@@ -648,7 +1699,7 @@ void ParameterServer::parameterSetMin(int argc, t_atom* argv)
             if (canBeFloat(argv[argc-1]))
             {
                 rcp_parameter_set_min_float(RCP_VALUE_PARAMETER(parameter), argv[argc-1].a_w.w_float);
-                rcp_server_update(m_server);
+                serverUpdate();
             }
         }
         else if (type == DATATYPE_INT32)
@@ -656,7 +1707,7 @@ void ParameterServer::parameterSetMin(int argc, t_atom* argv)
             if (canBeInt(argv[argc-1]))
             {
                 rcp_parameter_set_min_int32(RCP_VALUE_PARAMETER(parameter), getInt(argv[argc-1]));
-                rcp_server_update(m_server);
+                serverUpdate();
             }
         }
     }
@@ -664,7 +1715,7 @@ void ParameterServer::parameterSetMin(int argc, t_atom* argv)
 
 void ParameterServer::parameterSetMax(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
 
     rcp_parameter* parameter = getParameter(argc-1, argv);
     if (parameter)
@@ -675,7 +1726,7 @@ void ParameterServer::parameterSetMax(int argc, t_atom* argv)
             if (canBeFloat(argv[argc-1]))
             {
                 rcp_parameter_set_max_float(RCP_VALUE_PARAMETER(parameter), argv[argc-1].a_w.w_float);
-                rcp_server_update(m_server);
+                serverUpdate();
             }
         }
         else if (type == DATATYPE_INT32)
@@ -683,7 +1734,7 @@ void ParameterServer::parameterSetMax(int argc, t_atom* argv)
             if (canBeInt(argv[argc-1]))
             {
                 rcp_parameter_set_max_int32(RCP_VALUE_PARAMETER(parameter), getInt(argv[argc-1]));
-                rcp_server_update(m_server);
+                serverUpdate();
             }
         }
     }
@@ -699,7 +1750,7 @@ void ParameterServer::parameterSetMinMax(int argc, t_atom* argv)
         return;
     }
 
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
 
     rcp_parameter* parameter = getParameter(argc-2, argv);
     if (parameter)
@@ -709,13 +1760,13 @@ void ParameterServer::parameterSetMinMax(int argc, t_atom* argv)
         {
             rcp_parameter_set_min_float(RCP_VALUE_PARAMETER(parameter), argv[argc-2].a_w.w_float);
             rcp_parameter_set_max_float(RCP_VALUE_PARAMETER(parameter), argv[argc-1].a_w.w_float);
-            rcp_server_update(m_server);
+            serverUpdate();
         }
         else if (type == DATATYPE_INT32)
         {
             rcp_parameter_set_min_int32(RCP_VALUE_PARAMETER(parameter), getInt(argv[argc-2]));
             rcp_parameter_set_max_int32(RCP_VALUE_PARAMETER(parameter), getInt(argv[argc-1]));
-            rcp_server_update(m_server);
+            serverUpdate();
         }
     }
 }
@@ -723,7 +1774,7 @@ void ParameterServer::parameterSetMinMax(int argc, t_atom* argv)
 // rabbithole
 void ParameterServer::setRabbithole(const std::string& uri)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
 
     if (!uri.empty() &&
         uri.rfind("ws", 0) != 0 &&
@@ -742,7 +1793,7 @@ void ParameterServer::setRabbithole(const std::string& uri)
     {
         if (m_server)
         {
-            m_rabbitholeTransporter = std::make_shared<RabbitHoleServerTransporter>((t_pd*)m_x, m_server);
+            m_rabbitholeTransporter = std::make_shared<RabbitHoleServerTransporter>((t_pd*)m_x, m_server, m_mutex);
         }
 
         if (m_rabbitholeTransporter)
@@ -772,4 +1823,15 @@ void ParameterServer::handleRawData(char* data, size_t size)
     }
 }
 
+void ParameterServer::transporterMemory(size_t& queuedBytes, size_t& payloads) const
+{
+    queuedBytes = 0;
+    payloads = 0;
+
+    if (m_transporter)
+    {
+        m_transporter->memoryUsage(queuedBytes, payloads);
+    }
+}
+
 } // namespace rcp
@@ -38,16 +38,31 @@
 #ifndef RCP_PARAMETERSERVER_H
 #define RCP_PARAMETERSERVER_H
 
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include <rcp_server.h>
 
 #include "IServerTransporter.h"
+#include "Optional.h"
 #include "ParameterServerClientBase.h"
+#include "Preset.h"
 #include "RabbitHoleServerTransporter.h"
 #include "rabbit.server.h"
 
+// warn when begin nests this deep - most likely a missing commit
+#define RCP_TRANSACTION_WARN_DEPTH 16
+// warn when a transaction stays open this long
+#define RCP_TRANSACTION_TIMEOUT_MS 5000
+
 namespace rcp
 {
 
+struct SchemaNode;
+
 class ParameterServer
     : public ParameterServerClientBase
 {
@@ -61,11 +76,50 @@ public:
 
     size_t clientCount() const;
 
+    // per client outbound limits
+    void setMaxQueue(int bytes);
+    void setMaxRate(float updatesPerSecond);
+    void outputClientStats() const;
+
+    // send packets of one flush in few frames
+    void setBatch(bool batch);
+    void outputSendStats() const;
+
+    // -raw output ring
+    void outputRawStats() const;
+
+public:
+    // transaction: changes between begin and commit are sent once on commit
+    // nothing is sent while a begin is missing its commit - see transactionTimeout
+    void begin();
+    // all: close every open begin
+    void commit(bool all = false);
+    int transactionDepth() const;
+    // clock - warns if the transaction is still open
+    void transactionTimeout();
+
+    // info outlet and restored values - held back while the object is created
+    void outputInfo(t_symbol* selector, int argc, t_atom* argv);
+    // clock
+    void outputPendingInfo();
+
 public:
     // parameter
     void exposeParameter(int argc, t_atom* argv);
     void removeParameter(int id);
     void removeParameterList(int argc, t_atom* argv);
+    // create a parameter tree from a json file (see SchemaLoader)
+    // relative paths are relative to the patch
+    void loadSchema(const std::string& filename);
+    // binary image of the tree: structure, options and values (see ParameterState)
+    void saveState(const std::string& filename);
+    void loadState(const std::string& filename);
+
+    // preset store|recall|remove <name>, preset interpolate <a> <b> <t>
+    // recall applies all values under one lock and sends them with one update
+    // changed values are output like client changes, then "preset recalled <name>" on the info outlet
+    void preset(int argc, t_atom* argv);
+
     // parameter options
     void parameterSetReadonly(int argc, t_atom* argv);
     void parameterSetOrder(int argc, t_atom* argv);
@@ -79,20 +133,67 @@ public:
     void setRabbitholeInterval(const int i);
 
 private:
-    void outputIdParameterList(std::vector<t_atom>* list) override;
     void handleRawData(char* data, size_t size) override;
+    void transporterMemory(size_t& queuedBytes, size_t& payloads) const override;
 
 private:
+    // send changes - or mark them for commit
+    // call with m_mutex held
+    void serverUpdate();
+
     rcp_group_parameter* createGroups(int argc, t_atom* argv, std::string& outLabel);
+    rcp_group_parameter* findOrCreateGroup(t_symbol* name, rcp_group_parameter* parent);
     void setupValueParameter(rcp_value_parameter* parameter);
 
+    // expose one parameter with options and default value
+    // call with m_mutex held - does not send
+    rcp_parameter* createParameter(rcp_datatype datatype,
+                                   const char* label,
+                                   rcp_group_parameter* group,
+                                   const Optional<float>& min,
+                                   const Optional<float>& max,
+                                   const Optional<bool>& readonly,
+                                   const Optional<int>& order);
+    // returns number of parameters created
+    size_t createSchemaNodes(const std::vector<SchemaNode>& nodes, rcp_group_parameter* group);
+
+    static rcp_datatype parseDatatype(const char* type_str);
+
+    void storePreset(t_symbol* name);
+    void recallPreset(t_symbol* name);
+    void interpolatePreset(t_symbol* nameA, t_symbol* nameB, float t);
+    // output the current values of ids - call without m_mutex held
+    void outputParameters(const std::vector<int16_t>& ids);
+    // set a value if it differs - call with m_mutex held
+    bool applyPresetValue(const PresetValue& value, const std::vector<std::string>& strings);
+
+    // relative to the directory of the patch
+    std::string resolvePath(const std::string& filename) const;
+
 private:
     t_rabbit_server_pd* m_x{nullptr};
+    // directory of the patch
+    t_symbol* m_dir{nullptr};
 
     IServerTransporter* m_transporter{nullptr};
     rcp_server* m_server{nullptr};
 
     std::shared_ptr<RabbitHoleServerTransporter> m_rabbitholeTransporter;
+
+    // pd thread only
+    std::unordered_map<t_symbol*, Preset> m_presets;
+
+    // armed by the outermost begin
+    t_clock* m_transactionClock{nullptr};
+
+    t_clock* m_infoClock{nullptr};
+    bool m_deferInfo{false};
+    std::vector<std::pair<t_symbol*, std::vector<t_atom> > > m_pendingInfo;
+    std::vector<int16_t> m_pendingValues;
+
+    // ids created by @schema / @state (or loadschema / loadstate)
+    // a later expose of the same label and type takes them over instead of failing
+    std::unordered_set<int16_t> m_adoptable;
 };
 
 } // namespace rcp
@@ -125,6 +125,41 @@ static bool setAtomValue(rcp_parameter* param, const t_atom& atom)
 }
 
 
+// synchronized from threaded transporters
+
+static void pd_queued_messages_output(t_pd *obj, void *data)
+{
+    if (obj != NULL &&
+        data != NULL)
+    {
+        ((rcp::ParameterServerClientBase*)data)->outputQueuedMessages();
+    }
+}
+
+static void _flush_clock_tick(rcp::ParameterServerClientBase* x)
+{
+    x->flush();
+}
+
+static void pd_overflow_message_output(t_pd *obj, void *data)
+{
+    rcp::OverflowMessage* msg = (rcp::OverflowMessage*)data;
+
+    if (obj != NULL &&
+        msg != NULL)
+    {
+        msg->owner->outputOverflow(msg);
+        return;
+    }
+
+    // cancelled - owner is gone
+    if (msg)
+    {
+        delete msg;
+    }
+}
+
+
 static std::string typeToString(rcp_datatype type)
 {
     switch(type)
@@ -152,7 +187,70 @@ namespace rcp
 
 ParameterServerClientBase::ParameterServerClientBase(void* obj)
     : m_obj(obj)
+    , m_messages(*this, RCP_PARAMETER_MESSAGE_QUEUE_SIZE, RCP_PARAMETER_MESSAGE_POOL_SIZE)
+{
+    m_flushClock = clock_new(this, (t_method)_flush_clock_tick);
+}
+
+ParameterServerClientBase::~ParameterServerClientBase()
+{
+    if (m_flushClock)
+    {
+        clock_free(m_flushClock);
+        m_flushClock = nullptr;
+    }
+}
+
+void ParameterServerClientBase::setDefer(bool defer)
+{
+    m_defer = defer;
+
+    if (!m_defer &&
+        m_flushScheduled)
+    {
+        // send what is pending
+        clock_unset(m_flushClock);
+        flush();
+    }
+}
+
+void ParameterServerClientBase::flush()
+{
+    Threading::Lock lock(m_mutex);
+
+    m_flushScheduled = false;
+
+    if (m_transaction > 0)
+    {
+        // sent on commit
+        m_transactionDirty = true;
+        return;
+    }
+
+    rcp_manager_update(m_manager);
+}
+
+void ParameterServerClientBase::updateManager()
 {
+    if (m_transaction > 0)
+    {
+        // sent on commit
+        m_transactionDirty = true;
+        return;
+    }
+
+    if (!m_defer)
+    {
+        rcp_manager_update(m_manager);
+        return;
+    }
+
+    // parameter are dirty - send them once at the end of this logical time
+    if (!m_flushScheduled)
+    {
+        m_flushScheduled = true;
+        clock_delay(m_flushClock, 0);
+    }
 }
 
 void ParameterServerClientBase::_input(rcp_parameter* parameter, int argc, t_atom* argv)
@@ -187,14 +285,14 @@ void ParameterServerClientBase::_input(rcp_parameter* parameter, int argc, t_ato
         else if (rcp_parameter_is_type(parameter, DATATYPE_BANG))
         {
             rcp_manager_set_dirty(m_manager, parameter);
-            rcp_manager_update(m_manager);
+            updateManager();
             return;
         }
 
         // set value
         if (setAtomValue(parameter, argv[argc-1]))
         {
-            rcp_manager_update(m_manager);
+            updateManager();
         }
     }
 }
@@ -212,74 +310,164 @@ void ParameterServerClientBase::list(int argc, t_atom* argv)
         id = getInt(argv[0]);
     }
 
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::TimedLock lock(m_mutex, LOCK_SITE_LIST);
 
     if (id != 0)
     {
-        rcp_parameter* p = rcp_manager_get_parameter(m_manager, id);
+        rcp_parameter* p = findParameter(id);
 
         if (setAtomValue(p, argv[argc-1]))
         {
-            rcp_manager_update(m_manager);
+            updateManager();
             return;
         }
     }
 
     if (argv[0].a_type == A_SYMBOL)
     {
-        rcp_parameter* param = rcp_manager_find_parameter(m_manager, argv[0].a_w.w_symbol->s_name, NULL);
+        rcp_parameter* param = findParameter(argv[0].a_w.w_symbol, NULL);
         _input(param, argc-1, argv+1);
     }
 }
 
-void ParameterServerClientBase::any(t_symbol* sym, int argc, t_atom* argv)
+const ParameterServerClientBase::CommandMap& ParameterServerClientBase::commands()
 {
-    if (sym == gensym("__raw_input"))
+    // symbols are interned: built once, looked up by pointer
+    static CommandMap map;
+
+    if (map.empty())
     {
-        if (m_raw)
-        {
-            _rawDataList(argc, argv);
-            return;
-        }
+        map[gensym("getinfo")] = &ParameterServerClientBase::parameterInfo;
+        map[gensym("getid")] = &ParameterServerClientBase::parameterId;
+        map[gensym("gettype")] = &ParameterServerClientBase::parameterType;
+        map[gensym("getvalue")] = &ParameterServerClientBase::parameterValue;
+        map[gensym("getreadonly")] = &ParameterServerClientBase::parameterReadonly;
+        map[gensym("getorder")] = &ParameterServerClientBase::parameterOrder;
+        map[gensym("getmin")] = &ParameterServerClientBase::parameterMin;
+        map[gensym("getmax")] = &ParameterServerClientBase::parameterMax;
+        map[gensym("getqueuestats")] = &ParameterServerClientBase::parameterQueueStats;
+        map[gensym("getlockstats")] = &ParameterServerClientBase::parameterLockStats;
+        map[gensym("getmemory")] = &ParameterServerClientBase::parameterMemory;
     }
 
-    if (strcmp(sym->s_name, "getinfo") == 0)
+    return map;
+}
+
+void ParameterServerClientBase::setMany(int argc, t_atom* argv)
+{
+    if (argc % 2 != 0)
     {
-        parameterInfo(argc, argv);
+        pd_error(m_obj, "setmany: expected <id> <value> pairs");
+        return;
     }
-    else if (strcmp(sym->s_name, "getid") == 0)
+
+    Threading::TimedLock lock(m_mutex, LOCK_SITE_LIST);
+
+    bool changed = false;
+
+    for (int i=0; i<argc; i+=2)
     {
-        parameterId(argc, argv);
+        if (!canBeInt(argv[i]))
+        {
+            pd_error(m_obj, "setmany: invalid id");
+            continue;
+        }
+
+        rcp_parameter* parameter = findParameter((int16_t)getInt(argv[i]));
+        if (parameter == NULL)
+        {
+            pd_error(m_obj, "setmany: parameter not found: %d", getInt(argv[i]));
+            continue;
+        }
+
+        changed |= _setValue(parameter, argv[i+1]);
     }
-    else if (strcmp(sym->s_name, "gettype") == 0)
+
+    if (changed)
     {
-        parameterType(argc, argv);
+        updateManager();
     }
-    else if (strcmp(sym->s_name, "getvalue") == 0)
+}
+
+void ParameterServerClientBase::setManyPath(int argc, t_atom* argv)
+{
+    Threading::TimedLock lock(m_mutex, LOCK_SITE_LIST);
+
+    bool changed = false;
+    int i = 0;
+
+    while (i < argc)
     {
-        parameterValue(argc, argv);
+        if (!canBeInt(argv[i]))
+        {
+            pd_error(m_obj, "setmanypath: expected path depth");
+            break;
+        }
+
+        int depth = getInt(argv[i]);
+        if (depth < 1 ||
+            i + 1 + depth >= argc)
+        {
+            pd_error(m_obj, "setmanypath: invalid path depth: %d", depth);
+            break;
+        }
+
+        rcp_parameter* parameter = getParameter(depth, argv + i + 1);
+        if (parameter == NULL)
+        {
+            pd_error(m_obj, "setmanypath: parameter not found");
+        }
+        else
+        {
+            changed |= _setValue(parameter, argv[i + 1 + depth]);
+        }
+
+        i += depth + 2;
     }
-    else if (strcmp(sym->s_name, "getreadonly") == 0)
+
+    if (changed)
     {
-        parameterReadonly(argc, argv);
+        updateManager();
     }
-    else if (strcmp(sym->s_name, "getorder") == 0)
+}
+
+bool ParameterServerClientBase::_setValue(rcp_parameter* parameter, const t_atom& value)
+{
+    if (rcp_parameter_is_type(parameter, DATATYPE_BANG))
     {
-        parameterOrder(argc, argv);
+        rcp_manager_set_dirty(m_manager, parameter);
+        return true;
     }
-    else if (strcmp(sym->s_name, "getmin") == 0)
+
+    return setAtomValue(parameter, value);
+}
+
+void ParameterServerClientBase::any(t_symbol* sym, int argc, t_atom* argv)
+{
+    static t_symbol* s_raw_input = gensym("__raw_input");
+
+    if (sym == s_raw_input)
     {
-        parameterMin(argc, argv);
+        if (m_raw)
+        {
+            _rawDataList(argc, argv);
+            return;
+        }
     }
-    else if (strcmp(sym->s_name, "getmax") == 0)
+
+    const CommandMap& map = commands();
+    CommandMap::const_iterator it = map.find(sym);
+
+    if (it != map.end())
     {
-        parameterMax(argc, argv);
+        (this->*(it->second))(argc, argv);
     }
     else
     {
-        std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+        // root parameter by label - see ParameterIndex
+        Threading::TimedLock lock(m_mutex, LOCK_SITE_ANY);
 
-        rcp_parameter* param = rcp_manager_find_parameter(m_manager, sym->s_name, NULL);
+        rcp_parameter* param = findParameter(sym, NULL);
         _input(param, argc, argv);
     }
 }
@@ -316,7 +504,7 @@ void ParameterServerClientBase::_rawDataList(int argc, t_atom* argv)
 
 void ParameterServerClientBase::bang() const
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::Lock lock(m_mutex);
 
     rcp_parameter_list* list = rcp_manager_get_paramter_list(m_manager);
     post("---- parameter ----");
@@ -334,169 +522,209 @@ void ParameterServerClientBase::dataOut(const char* data, size_t size) const
 {
     if (m_rawDataOutlet)
     {
-        std::vector<t_atom> atoms(size);
+        // reuse the atoms
+        m_rawAtoms.resize(size);
 
         for (size_t i=0; i<size; i++)
         {
-            setInt(atoms[i], data[i]);
+            setInt(m_rawAtoms[i], data[i]);
         }
 
-        outlet_list(m_rawDataOutlet, &s_list, size, atoms.data());
+        outlet_list(m_rawDataOutlet, &s_list, size, m_rawAtoms.data());
     }
 }
 
 
-void ParameterServerClientBase::_outputInfo(rcp_parameter* parameter, int argc, t_atom* argv)
+Threading::Mutex& ParameterServerClientBase::mutex() const
 {
-    if (parameter)
+    return m_mutex;
+}
+
+void ParameterServerClientBase::invalidateParameterIndex()
+{
+    m_index.invalidate();
+}
+
+ParameterIndex& ParameterServerClientBase::index()
+{
+    m_index.validate(m_manager);
+    return m_index;
+}
+
+
+bool ParameterServerClientBase::_infoList(rcp_parameter* parameter, int argc, t_atom* argv, std::vector<t_atom>& list)
+{
+    if (parameter == NULL)
     {
-        rcp_typedefinition* td = rcp_parameter_get_typedefinition(parameter);
+        return false;
+    }
 
-        int16_t id = rcp_parameter_get_id(parameter);
-        rcp_datatype type = RCP_TYPE_ID(parameter);
-        std::string ts = typeToString(type);
+    rcp_typedefinition* td = rcp_parameter_get_typedefinition(parameter);
 
-        // info <group-label-list> <value> <min> <max> <id> <type>
+    int16_t id = rcp_parameter_get_id(parameter);
+    rcp_datatype type = RCP_TYPE_ID(parameter);
+    std::string ts = typeToString(type);
 
-        int len = 2 + argc;
-        bool has_min = false;
-        bool has_max = false;
+    // info <group-label-list> <value> <min> <max> <id> <type>
 
-        if (rcp_parameter_is_value(parameter))
-        {
-            len++;
+    int len = 2 + argc;
+    bool has_min = false;
+    bool has_max = false;
 
-            if (type == DATATYPE_FLOAT32 || type == DATATYPE_INT32)
+    if (rcp_parameter_is_value(parameter))
+    {
+        len++;
+
+        if (type == DATATYPE_FLOAT32 || type == DATATYPE_INT32)
+        {
+            // check if we have min and max
+            if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MINIMUM))
             {
-                // check if we have min and max
-                if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MINIMUM))
-                {
-                    has_min = true;
-                    len++;
-                }
+                has_min = true;
+                len++;
+            }
 
-                if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MAXIMUM))
-                {
-                    has_max = true;
-                    len++;
-                }
+            if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MAXIMUM))
+            {
+                has_max = true;
+                len++;
             }
         }
+    }
 
 
-        std::vector<t_atom> list(len);
+    list.resize(len);
 
-        int i=0;
-        for (int j=0; j<argc; j++, i++) {
-            list[i] = argv[j];
-        }
+    int i=0;
+    for (int j=0; j<argc; j++, i++) {
+        list[i] = argv[j];
+    }
 
-        // set value
-        if (type == DATATYPE_BOOLEAN)
+    // set value
+    if (type == DATATYPE_BOOLEAN)
+    {
+        setInt(list[i], rcp_parameter_get_value_bool(RCP_VALUE_PARAMETER(parameter)) ? 1 : 0);
+        i++;
+    }
+    else if (type == DATATYPE_INT32)
+    {
+        setInt(list[i], rcp_parameter_get_value_int32(RCP_VALUE_PARAMETER(parameter)));
+        i++;
+
+        if (has_min)
         {
-            setInt(list[i], rcp_parameter_get_value_bool(RCP_VALUE_PARAMETER(parameter)) ? 1 : 0);
+            // add min
+            setInt(list[i], rcp_typedefinition_get_option_i32(td, NUMBER_OPTIONS_MINIMUM, 0));
             i++;
         }
-        else if (type == DATATYPE_INT32)
+
+        if (has_max)
         {
-            setInt(list[i], rcp_parameter_get_value_int32(RCP_VALUE_PARAMETER(parameter)));
+            // add max
+            setInt(list[i], rcp_typedefinition_get_option_i32(td, NUMBER_OPTIONS_MAXIMUM, 0));
             i++;
-
-            if (has_min)
-            {
-                // add min
-                setInt(list[i], rcp_typedefinition_get_option_i32(td, NUMBER_OPTIONS_MINIMUM, 0));
-                i++;
-            }
-
-            if (has_max)
-            {
-                // add max
-                setInt(list[i], rcp_typedefinition_get_option_i32(td, NUMBER_OPTIONS_MAXIMUM, 0));
-                i++;
-            }
         }
-        else if (type == DATATYPE_FLOAT32)
+    }
+    else if (type == DATATYPE_FLOAT32)
+    {
+        setFloat(list[i], rcp_parameter_get_value_float(RCP_VALUE_PARAMETER(parameter)));
+        i++;
+
+        if (has_min)
         {
-            setFloat(list[i], rcp_parameter_get_value_float(RCP_VALUE_PARAMETER(parameter)));
+            // add min
+            setFloat(list[i], rcp_typedefinition_get_option_f32(td, NUMBER_OPTIONS_MINIMUM, 0));
             i++;
-
-            if (has_min)
-            {
-                // add min
-                setFloat(list[i], rcp_typedefinition_get_option_f32(td, NUMBER_OPTIONS_MINIMUM, 0));
-                i++;
-            }
-
-            if (has_max)
-            {
-                // add max
-                setFloat(list[i], rcp_typedefinition_get_option_f32(td, NUMBER_OPTIONS_MAXIMUM, 0));
-                i++;
-            }
         }
-        else if (type == DATATYPE_STRING)
+
+        if (has_max)
         {
-            setString(list[i], rcp_parameter_get_value_string(RCP_VALUE_PARAMETER(parameter)));
+            // add max
+            setFloat(list[i], rcp_typedefinition_get_option_f32(td, NUMBER_OPTIONS_MAXIMUM, 0));
             i++;
         }
-
-        setInt(list[i], id);
+    }
+    else if (type == DATATYPE_STRING)
+    {
+        setString(list[i], rcp_parameter_get_value_string(RCP_VALUE_PARAMETER(parameter)));
         i++;
+    }
 
-        setString(list[i], ts.c_str());
-        i++;
+    setInt(list[i], id);
+    i++;
 
-        outlet_anything(m_infoOutlet, gensym("info"), list.size(), list.data());
-    }
+    setString(list[i], ts.c_str());
+    i++;
+
+    return true;
 }
 
+// NOTE: getters collect their output with the lock held
+//       and output after releasing it
+
 void ParameterServerClientBase::parameterInfo(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    std::vector<std::vector<t_atom> > infos;
 
-    if (argc == 0)
     {
-        // output all
-        rcp_parameter_list* list = rcp_manager_get_paramter_list(m_manager);
-        while (list != NULL)
+        Threading::Lock lock(m_mutex);
+
+        if (argc == 0)
         {
-            std::vector<std::string> groups = getParents(list->parameter);
+            // output all
+            rcp_parameter_list* list = rcp_manager_get_paramter_list(m_manager);
+            while (list != NULL)
+            {
+                std::vector<t_symbol*> buffer;
+                const std::vector<t_symbol*>& path = getPath(list->parameter, buffer);
 
-            std::vector<t_atom> groups_a(groups.size());
+                std::vector<t_atom> groups_a(path.size());
 
-            int i = 0;
-            for(std::vector<std::string>::reverse_iterator rit = groups.rbegin();
-                 rit != groups.rend(); ++rit)
-            {
-                setString(groups_a[i], rit->c_str());
-                i++;
-            }
+                for (size_t i=0; i<path.size(); i++)
+                {
+                    setSymbol(groups_a[i], path[i]);
+                }
 
-            _outputInfo(list->parameter, groups.size(), groups_a.data());
+                infos.push_back(std::vector<t_atom>());
+                _infoList(list->parameter, path.size(), groups_a.data(), infos.back());
 
-            list = list->next;
+                list = list->next;
+            }
+        }
+        else
+        {
+            infos.push_back(std::vector<t_atom>());
+            if (!_infoList(getParameter(argc, argv), argc, argv, infos.back()))
+            {
+                return;
+            }
         }
     }
-    else
+
+    for (size_t i=0; i<infos.size(); i++)
     {
-        rcp_parameter* parameter = getParameter(argc, argv);
-        _outputInfo(parameter, argc, argv);
+        outlet_anything(m_infoOutlet, gensym("info"), infos[i].size(), infos[i].data());
     }
 }
 
 void ParameterServerClientBase::parameterId(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    std::vector<t_atom> list;
 
-    rcp_parameter* parameter = getParameter(argc, argv);
-    if (parameter)
     {
+        Threading::Lock lock(m_mutex);
+
+        rcp_parameter* parameter = getParameter(argc, argv);
+        if (parameter == NULL)
+        {
+            return;
+        }
+
         int16_t id = rcp_parameter_get_id(parameter);
 
         // id <group-label-list> <id>
         int len = 1 + argc;
-        std::vector<t_atom> list(len);
+        list.resize(len);
 
         int i=0;
         for (int j=0; j<argc; j++, i++) {
@@ -505,26 +733,31 @@ void ParameterServerClientBase::parameterId(int argc, t_atom* argv)
 
         setInt(list[i], id);
         i++;
-
-        outlet_anything(m_infoOutlet, gensym("id"), list.size(), list.data());
     }
+
+    outlet_anything(m_infoOutlet, gensym("id"), list.size(), list.data());
 }
 
 void ParameterServerClientBase::parameterType(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    std::vector<t_atom> list;
 
-    rcp_parameter* parameter = getParameter(argc, argv);
-    if (parameter)
     {
-        rcp_typedefinition* td = rcp_parameter_get_typedefinition(parameter);
+        Threading::Lock lock(m_mutex);
+
+        rcp_parameter* parameter = getParameter(argc, argv);
+        if (parameter == NULL)
+        {
+            return;
+        }
+
         rcp_datatype type = RCP_TYPE_ID(parameter);
         std::string ts = typeToString(type);
 
 
         // id <group-label-list> <type>
         int len = 1 + argc;
-        std::vector<t_atom> list(len);
+        list.resize(len);
 
         int i=0;
         for (int j=0; j<argc; j++, i++) {
@@ -533,23 +766,29 @@ void ParameterServerClientBase::parameterType(int argc, t_atom* argv)
 
         setString(list[i], ts.c_str());
         i++;
-
-        outlet_anything(m_infoOutlet, gensym("type"), list.size(), list.data());
     }
+
+    outlet_anything(m_infoOutlet, gensym("type"), list.size(), list.data());
 }
 
 void ParameterServerClientBase::parameterReadonly(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    std::vector<t_atom> list;
 
-    rcp_parameter* parameter = getParameter(argc, argv);
-    if (parameter)
     {
+        Threading::Lock lock(m_mutex);
+
+        rcp_parameter* parameter = getParameter(argc, argv);
+        if (parameter == NULL)
+        {
+            return;
+        }
+
         bool ro = rcp_parameter_get_readonly(parameter);
 
         // readonly <group-label-list> <ro>
         int len = 1 + argc;
-        std::vector<t_atom> list(len);
+        list.resize(len);
 
         int i=0;
         for (int j=0; j<argc; j++, i++) {
@@ -558,23 +797,29 @@ void ParameterServerClientBase::parameterReadonly(int argc, t_atom* argv)
 
         setInt(list[i], ro ? 1 : 0);
         i++;
-
-        outlet_anything(m_infoOutlet, gensym("readonly"), list.size(), list.data());
     }
+
+    outlet_anything(m_infoOutlet, gensym("readonly"), list.size(), list.data());
 }
 
 void ParameterServerClientBase::parameterOrder(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    std::vector<t_atom> list;
 
-    rcp_parameter* parameter = getParameter(argc, argv);
-    if (parameter)
     {
+        Threading::Lock lock(m_mutex);
+
+        rcp_parameter* parameter = getParameter(argc, argv);
+        if (parameter == NULL)
+        {
+            return;
+        }
+
         int32_t order = rcp_parameter_get_order(parameter);
 
         // order <group-label-list> <order>
         int len = 1 + argc;
-        std::vector<t_atom> list(len);
+        list.resize(len);
 
         int i=0;
         for (int j=0; j<argc; j++, i++) {
@@ -583,23 +828,29 @@ void ParameterServerClientBase::parameterOrder(int argc, t_atom* argv)
 
         setInt(list[i], order);
         i++;
-
-        outlet_anything(m_infoOutlet, gensym("order"), list.size(), list.data());
     }
+
+    outlet_anything(m_infoOutlet, gensym("order"), list.size(), list.data());
 }
 
 void ParameterServerClientBase::parameterValue(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    std::vector<t_atom> list;
 
-    rcp_parameter* parameter = getParameter(argc, argv);
-    if (parameter)
     {
+        Threading::Lock lock(m_mutex);
+
+        rcp_parameter* parameter = getParameter(argc, argv);
+        if (parameter == NULL)
+        {
+            return;
+        }
+
         rcp_datatype type = RCP_TYPE_ID(parameter);
 
         // value <group-label-list> <value>
         int len = argc + (rcp_parameter_is_value(parameter) ? 1 : 0);
-        std::vector<t_atom> list(len);
+        list.resize(len);
 
         int i=0;
         for (int j=0; j<argc; j++, i++) {
@@ -626,83 +877,99 @@ void ParameterServerClientBase::parameterValue(int argc, t_atom* argv)
             setString(list[i], rcp_parameter_get_value_string(RCP_VALUE_PARAMETER(parameter)));
             i++;
         }
-
-        outlet_anything(m_infoOutlet, gensym("value"), list.size(), list.data());
     }
+
+    outlet_anything(m_infoOutlet, gensym("value"), list.size(), list.data());
 }
 
 void ParameterServerClientBase::parameterMin(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    std::vector<t_atom> list;
 
-    rcp_parameter* parameter = getParameter(argc, argv);
-    if (parameter)
     {
+        Threading::Lock lock(m_mutex);
+
+        rcp_parameter* parameter = getParameter(argc, argv);
+        if (parameter == NULL)
+        {
+            return;
+        }
+
         rcp_typedefinition* td = rcp_parameter_get_typedefinition(parameter);
         rcp_datatype type = RCP_TYPE_ID(parameter);
 
-        if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MINIMUM))
+        if (!rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MINIMUM))
         {
-            // min <group-label-list> <min>
-            int len = argc + 1;
-            std::vector<t_atom> list(len);
+            return;
+        }
 
-            int i=0;
-            for (int j=0; j<argc; j++, i++) {
-                list[i] = argv[j];
-            }
+        // min <group-label-list> <min>
+        int len = argc + 1;
+        list.resize(len);
 
-            if (type == DATATYPE_INT32)
-            {
-                setInt(list[i], rcp_parameter_get_min_int32(RCP_VALUE_PARAMETER(parameter)));
-                i++;
-            }
-            else if (type == DATATYPE_FLOAT32)
-            {
-                setFloat(list[i], rcp_parameter_get_min_float(RCP_VALUE_PARAMETER(parameter)));
-                i++;
-            }
+        int i=0;
+        for (int j=0; j<argc; j++, i++) {
+            list[i] = argv[j];
+        }
 
-            outlet_anything(m_infoOutlet, gensym("min"), list.size(), list.data());
+        if (type == DATATYPE_INT32)
+        {
+            setInt(list[i], rcp_parameter_get_min_int32(RCP_VALUE_PARAMETER(parameter)));
+            i++;
+        }
+        else if (type == DATATYPE_FLOAT32)
+        {
+            setFloat(list[i], rcp_parameter_get_min_float(RCP_VALUE_PARAMETER(parameter)));
+            i++;
         }
     }
+
+    outlet_anything(m_infoOutlet, gensym("min"), list.size(), list.data());
 }
 
 void ParameterServerClientBase::parameterMax(int argc, t_atom* argv)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    std::vector<t_atom> list;
 
-    rcp_parameter* parameter = getParameter(argc, argv);
-    if (parameter)
     {
+        Threading::Lock lock(m_mutex);
+
+        rcp_parameter* parameter = getParameter(argc, argv);
+        if (parameter == NULL)
+        {
+            return;
+        }
+
         rcp_typedefinition* td = rcp_parameter_get_typedefinition(parameter);
         rcp_datatype type = RCP_TYPE_ID(parameter);
 
-        if (rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MAXIMUM))
+        if (!rcp_typedefinition_has_option(td, NUMBER_OPTIONS_MAXIMUM))
         {
-            // max <group-label-list> <max>
-            int len = argc + 1;
-            std::vector<t_atom> list(len);
+            return;
+        }
 
-            int i=0;
-            for (int j=0; j<argc; j++, i++) {
-                list[i] = argv[j];
-            }
+        // max <group-label-list> <max>
+        int len = argc + 1;
+        list.resize(len);
 
-            if (type == DATATYPE_INT32)
-            {
-                setInt(list[i], rcp_parameter_get_max_int32(RCP_VALUE_PARAMETER(parameter)));
-                i++;
-            }
-            else if (type == DATATYPE_FLOAT32)
-            {
-                setFloat(list[i], rcp_parameter_get_max_float(RCP_VALUE_PARAMETER(parameter)));
-                i++;
-            }
+        int i=0;
+        for (int j=0; j<argc; j++, i++) {
+            list[i] = argv[j];
+        }
 
-            outlet_anything(m_infoOutlet, gensym("max"), list.size(), list.data());
+        if (type == DATATYPE_INT32)
+        {
+            setInt(list[i], rcp_parameter_get_max_int32(RCP_VALUE_PARAMETER(parameter)));
+            i++;
+        }
+        else if (type == DATATYPE_FLOAT32)
+        {
+            setFloat(list[i], rcp_parameter_get_max_float(RCP_VALUE_PARAMETER(parameter)));
+            i++;
         }
     }
+
+    outlet_anything(m_infoOutlet, gensym("max"), list.size(), list.data());
 }
 
 std::string ParameterServerClientBase::GetAsString(const t_atom &a)
@@ -739,7 +1006,7 @@ rcp_parameter* ParameterServerClientBase::getParameter(int argc, t_atom* argv, r
             return NULL;
         }
 
-        param = rcp_manager_find_parameter(m_manager, argv[i].a_w.w_symbol->s_name, last_group);
+        param = findParameter(argv[i].a_w.w_symbol, last_group);
         if (param == NULL)
         {
             // not found
@@ -755,58 +1022,134 @@ rcp_parameter* ParameterServerClientBase::getParameter(int argc, t_atom* argv, r
     return param;
 }
 
-std::vector<std::string> ParameterServerClientBase::getParents(rcp_parameter* parameter)
+rcp_parameter* ParameterServerClientBase::findParameter(t_symbol* label, rcp_group_parameter* group)
+{
+    ParameterIndex& parameters = index();
+    rcp_parameter* param = parameters.find(group, label);
+
+    if (param != NULL)
+    {
+        if (!parameters.verify())
+        {
+            return param;
+        }
+
+        // a remote server may change labels and parents
+        const char* current = rcp_parameter_get_label(param);
+        if (rcp_parameter_get_parent(param) == group &&
+            current != NULL &&
+            strcmp(current, label->s_name) == 0)
+        {
+            return param;
+        }
+
+        // stale - index it under its current key
+        parameters.add(param);
+    }
+
+    if (m_indexComplete)
+    {
+        return NULL;
+    }
+
+    // not indexed
+    param = rcp_manager_find_parameter(m_manager, label->s_name, group);
+    if (param != NULL)
+    {
+        parameters.add(param);
+    }
+
+    return param;
+}
+
+t_symbol* ParameterServerClientBase::getLabel(rcp_parameter* parameter)
+{
+    const char* label = rcp_parameter_get_label(parameter);
+    if (label == NULL)
+    {
+        return gensym("<nolabel>");
+    }
+
+    // a remote server may change labels
+    ParameterIndex& parameters = index();
+    t_symbol* sym = parameters.label(parameter);
+    if (sym != NULL &&
+        (!parameters.verify() || strcmp(sym->s_name, label) == 0))
+    {
+        return sym;
+    }
+
+    return gensym(label);
+}
+
+rcp_parameter* ParameterServerClientBase::findParameter(int16_t id)
+{
+    rcp_parameter* param = index().find(id);
+
+    if (param != NULL &&
+        rcp_parameter_get_id(param) == id)
+    {
+        return param;
+    }
+
+    // not indexed
+    return rcp_manager_get_parameter(m_manager, id);
+}
+
+const std::vector<t_symbol*>& ParameterServerClientBase::getPath(rcp_parameter* parameter, std::vector<t_symbol*>& buffer)
 {
-    std::vector<std::string> groups;
+    const std::vector<t_symbol*>* path = index().path(parameter);
+    if (path != NULL)
+    {
+        return *path;
+    }
+
+    // not indexed
+    buffer.clear();
 
     rcp_group_parameter* last_group = rcp_parameter_get_parent(RCP_PARAMETER(parameter));
     while (last_group != NULL)
     {
         const char* label = rcp_parameter_get_label(RCP_PARAMETER(last_group));
-        groups.push_back(label != NULL ? label : "null");
+        buffer.insert(buffer.begin(), gensym(label != NULL ? label : "null"));
 
         last_group = rcp_parameter_get_parent(RCP_PARAMETER(last_group));
     }
 
-    return groups;
+    return buffer;
 }
 
 
+
 void ParameterServerClientBase::parameterUpdate(rcp_parameter* parameter)
 {
-    std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+    Threading::TimedLock lock(m_mutex, LOCK_SITE_UPDATE);
 
-    const char* label = rcp_parameter_get_label(parameter);
     int16_t id = rcp_parameter_get_id(parameter);
     rcp_datatype type = rcp_typedefinition_get_type_id(rcp_parameter_get_typedefinition(parameter));
 
     // get the parents
-    std::vector<std::string> groups = getParents(parameter);
+    std::vector<t_symbol*> buffer;
+    const std::vector<t_symbol*>& path = getPath(parameter, buffer);
 
 
     // output [list]
     // update group1 groupN... label value
 
-    int len = 1 + 3 + groups.size();
-    std::vector<t_atom>* _list = new std::vector<t_atom>(len);
-    std::vector<t_atom>& list = *_list;
-
-    int i=0;
+    static t_symbol* s_update = gensym("update");
 
-    setFloat(list[i], id);
-    i++;
+    ParameterMessage message(id, s_update, 2 + path.size());
+    t_atom* list = message.atoms();
 
-    setSymbol(list[i], gensym("update"));
-    i++;
+    int i=0;
 
-    for (std::vector<std::string>::reverse_iterator rit = groups.rbegin();
-         rit != groups.rend(); ++rit)
+    for (size_t j=0; j<path.size(); j++)
     {
-        setString(list[i], rit->c_str());
+        setSymbol(list[i], path[j]);
         i++;
     }
 
-    setSymbol(list[i], gensym(label != NULL ? label : "<nolabel>"));
+    setSymbol(list[i], getLabel(parameter));
     i++;
 
     if (type == DATATYPE_BOOLEAN)
@@ -830,8 +1173,155 @@ void ParameterServerClientBase::parameterUpdate(rcp_parameter* parameter)
         i++;
     }
 
+    message.argc = i;
+
+    queueMessage(message);
+}
+
+void ParameterServerClientBase::queueMessage(ParameterMessage& message)
+{
+    // NOTE: called from transporter threads with m_mutex held
+    //       this serializes all producers of m_messages
+    m_messages.push(message);
+}
+
+void ParameterServerClientBase::outputQueuedMessages()
+{
+    m_messages.drain();
+}
+
+void ParameterServerClientBase::scheduleDrain()
+{
+    pd_queue_mess(&pd_maininstance, (t_pd*)m_obj, this, pd_queued_messages_output);
+}
+
+void ParameterServerClientBase::scheduleOverflow(OverflowMessage* message)
+{
+    pd_queue_mess(&pd_maininstance, (t_pd*)m_obj, message, pd_overflow_message_output);
+}
+
+void ParameterServerClientBase::outputMessage(ParameterMessage& message)
+{
+    if (message.selector)
+    {
+        outlet_float(m_parameterIdOutlet, message.id);
+        outlet_anything(m_parameterOutlet, message.selector, message.argc, message.atoms());
+    }
+}
+
+void ParameterServerClientBase::parameterQueueStats(int /*argc*/, t_atom* /*argv*/)
+{
+    // queuestats <pending> <capacity> <queued> <overflowed> <allocated>
+    t_atom list[5];
+
+    setInt(list[0], m_messages.size());
+    setInt(list[1], m_messages.capacity());
+    setFloat(list[2], m_messages.queued());
+    setFloat(list[3], m_messages.overflowed());
+    setFloat(list[4], m_messages.allocated());
+
+    outlet_anything(m_infoOutlet, gensym("queuestats"), 5, list);
+}
+
+void ParameterServerClientBase::parameterMemory(int /*argc*/, t_atom* /*argv*/)
+{
+    size_t tree_bytes = 0;
+    size_t string_bytes = 0;
+
+    {
+        Threading::Lock lock(m_mutex);
+
+        rcp_parameter_list* list = rcp_manager_get_paramter_list(m_manager);
+        while (list != NULL)
+        {
+            rcp_parameter* parameter = list->parameter;
+
+            tree_bytes += RCP_PARAMETER_SIZE_ESTIMATE;
+
+            const char* label = rcp_parameter_get_label(parameter);
+            if (label != NULL)
+            {
+                tree_bytes += strlen(label) + 1;
+            }
+
+            if (rcp_parameter_is_type(parameter, DATATYPE_STRING))
+            {
+                const char* value = rcp_parameter_get_value_string(RCP_VALUE_PARAMETER(parameter));
+                if (value != NULL)
+                {
+                    string_bytes += strlen(value) + 1;
+                }
+            }
+
+            list = list->next;
+        }
+    }
+
+    // messages waiting in the ring and outside of it
+    size_t payloads = m_messages.overflowPending();
+    size_t message_bytes = m_messages.size() * sizeof(ParameterMessage) +
+            payloads * sizeof(OverflowMessage);
+
+    size_t queue_bytes = 0;
+    size_t transporter_payloads = 0;
+    transporterMemory(queue_bytes, transporter_payloads);
+
+    // memory <tree> <string values> <messages> <send queues> <pd_queue_mess payloads>
+    // tree is an estimate: RCP_PARAMETER_SIZE_ESTIMATE per parameter plus its label
+    t_atom out[5];
+    setFloat(out[0], tree_bytes);
+    setFloat(out[1], string_bytes);
+    setFloat(out[2], message_bytes);
+    setFloat(out[3], queue_bytes);
+    setFloat(out[4], payloads + transporter_payloads);
+
+    outlet_anything(m_infoOutlet, gensym("memory"), 5, out);
+}
+
+void ParameterServerClientBase::setLockStats(bool enabled)
+{
+    m_mutex.stats().setEnabled(enabled);
+}
+
+void ParameterServerClientBase::parameterLockStats(int /*argc*/, t_atom* /*argv*/)
+{
+    const LockStats& stats = m_mutex.stats();
+
+    for (int i=0; i<LOCK_SITE_COUNT_; i++)
+    {
+        LockSite site = (LockSite)i;
+        const LockStats::Site& s = stats.site(site);
+        t_symbol* name = gensym(LockStats::siteName(site));
+
+        uint32_t count = s.count.load();
+
+        // lockstats <site> <count> <wait avg> <wait max> <hold avg> <hold max> (microseconds)
+        t_atom list[6];
+        setSymbol(list[0], name);
+        setFloat(list[1], count);
+        setFloat(list[2], count > 0 ? (float)s.waitTotal.load() / count : 0);
+        setFloat(list[3], s.waitMax.load());
+        setFloat(list[4], count > 0 ? (float)s.holdTotal.load() / count : 0);
+        setFloat(list[5], s.holdMax.load());
+
+        outlet_anything(m_infoOutlet, gensym("lockstats"), 6, list);
+
+        // lockwait|lockhold <site> <count <1us> <count <2us> ... <count >=16ms>
+        t_atom histogram[RCP_LOCK_STATS_BUCKETS + 1];
+        setSymbol(histogram[0], name);
 
-    outputIdParameterList(_list);
+        for (int j=0; j<RCP_LOCK_STATS_BUCKETS; j++)
+        {
+            setFloat(histogram[j+1], s.waitHistogram[j].load());
+        }
+        outlet_anything(m_infoOutlet, gensym("lockwait"), RCP_LOCK_STATS_BUCKETS + 1, histogram);
+
+        for (int j=0; j<RCP_LOCK_STATS_BUCKETS; j++)
+        {
+            setFloat(histogram[j+1], s.holdHistogram[j].load());
+        }
+        outlet_anything(m_infoOutlet, gensym("lockhold"), RCP_LOCK_STATS_BUCKETS + 1, histogram);
+    }
 }
 
 void ParameterServerClientBase::setOutlets(t_outlet* parameterOutlet,
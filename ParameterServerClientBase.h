@@ -38,20 +38,37 @@
 #ifndef PARAMETERSERVERCLIENTBASE_H
 #define PARAMETERSERVERCLIENTBASE_H
 
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <rcp_manager.h>
 
 #include <m_pd.h>
 
+#include "ParameterIndex.h"
+#include "ParameterMessage.h"
+#include "ParameterMessageQueue.h"
+#include "Threading.h"
+
+// parameter messages queued to the pd thread without allocation
+#define RCP_PARAMETER_MESSAGE_QUEUE_SIZE 1024
+// overflow messages kept for reuse
+#define RCP_PARAMETER_MESSAGE_POOL_SIZE 256
+// rough size of one rcp parameter without its label (struct, type definition, options)
+#define RCP_PARAMETER_SIZE_ESTIMATE 128
+
 namespace rcp
 {
 
 class ParameterServerClientBase
+    : public IParameterMessageOutput
 {
 public:
     ParameterServerClientBase(void* obj);
+    virtual ~ParameterServerClientBase();
 
     void parameterUpdate(rcp_parameter* parameter);
 
@@ -59,8 +76,35 @@ public:
     void list(int argc, t_atom* argv);
     void bang() const;
 
+    // set many values with one lock and one update
+    // setmany <id> <value> <id> <value> ...
+    void setMany(int argc, t_atom* argv);
+    // setmanypath <depth> <group> ... <label> <value> <depth> ...
+    void setManyPath(int argc, t_atom* argv);
+
     void dataOut(const char* data, size_t size) const;
 
+    // defer: collect value changes and send them once per logical time
+    void setDefer(bool defer);
+    void flush();
+
+    // record lock wait- and hold-times
+    void setLockStats(bool enabled);
+
+    Threading::Mutex& mutex() const;
+
+    // parameters are gone (e.g. connection lost) - any thread
+    void invalidateParameterIndex();
+
+    // pd thread - synchronized from threaded transporters
+    void outputQueuedMessages();
+
+public:
+    // IParameterMessageOutput
+    void scheduleDrain() override;
+    void scheduleOverflow(OverflowMessage* message) override;
+    void outputMessage(ParameterMessage& message) override;
+
 public:
     void parameterInfo(int argc, t_atom* argv);
     void parameterId(int argc, t_atom* argv);
@@ -70,15 +114,36 @@ public:
     void parameterValue(int argc, t_atom* argv);
     void parameterMin(int argc, t_atom* argv);
     void parameterMax(int argc, t_atom* argv);
+    void parameterQueueStats(int argc = 0, t_atom* argv = NULL);
+    void parameterLockStats(int argc = 0, t_atom* argv = NULL);
+    void parameterMemory(int argc = 0, t_atom* argv = NULL);
 
     std::string GetAsString(const t_atom &a);
     rcp_parameter* getParameter(int argc, t_atom* argv, rcp_group_parameter* group = NULL);
-    std::vector<std::string> getParents(rcp_parameter* parameter);
+    rcp_parameter* findParameter(t_symbol* label, rcp_group_parameter* group);
+    rcp_parameter* findParameter(int16_t id);
+    // parent group labels, root first - cached in m_index
+    // not indexed: filled into the caller's buffer
+    // call with m_mutex held, valid until the next structural change
+    const std::vector<t_symbol*>& getPath(rcp_parameter* parameter, std::vector<t_symbol*>& buffer);
+    t_symbol* getLabel(rcp_parameter* parameter);
 
 protected:
     // ParameterServerClientBase
-    virtual void outputIdParameterList(std::vector<t_atom>* list) = 0;
     virtual void handleRawData(char* data, size_t size) = 0;
+    // see IServerTransporter::memoryUsage
+    virtual void transporterMemory(size_t& queuedBytes, size_t& payloads) const { queuedBytes = 0; payloads = 0; }
+
+protected:
+    // send dirty parameter - or schedule it in defer mode
+    // pd thread - call with m_mutex held
+    void updateManager();
+
+    // hand a message to the pd thread - call with m_mutex held
+    void queueMessage(ParameterMessage& message);
+
+    // m_index, rebuilt if it was invalidated - call with m_mutex held
+    ParameterIndex& index();
 
 protected:
     void setOutlets(t_outlet* parameterOutlet,
@@ -88,21 +153,48 @@ protected:
 
 protected:
     bool m_raw{false};
+    bool m_defer{false};
+
+    // nesting depth of begin/commit - no updates are sent while > 0
+    int m_transaction{0};
+    bool m_transactionDirty{false};
 
     rcp_manager* m_manager{nullptr};
 
+    // parameters by (group, label) and by id, paths and children - maintained with m_mutex held
+    // use index(): it is rebuilt from m_manager after a disconnect
+    ParameterIndex m_index;
+    // every parameter is added to m_index: a miss needs no search in the manager
+    bool m_indexComplete{false};
+
+    // guards m_manager - shared with our transporters
+    mutable Threading::Mutex m_mutex;
+
     t_outlet* m_parameterOutlet{nullptr};
     t_outlet* m_parameterIdOutlet{nullptr};
     t_outlet* m_infoOutlet{nullptr};
     t_outlet* m_rawDataOutlet{nullptr};
+    mutable std::vector<t_atom> m_rawAtoms;
 
 private:
-    void _outputInfo(rcp_parameter* parameter, int argc, t_atom* argv);
+    // built-in commands of any() by selector
+    typedef void (ParameterServerClientBase::*Command)(int argc, t_atom* argv);
+    typedef std::unordered_map<t_symbol*, Command> CommandMap;
+    static const CommandMap& commands();
+
+    bool _infoList(rcp_parameter* parameter, int argc, t_atom* argv, std::vector<t_atom>& list);
     void _input(rcp_parameter* parameter, int argc, t_atom* argv);
+    bool _setValue(rcp_parameter* parameter, const t_atom& value);
     void _rawDataList(int argc, t_atom* argv);
 
 private:
     void* m_obj{nullptr};
+
+    t_clock* m_flushClock{nullptr};
+    bool m_flushScheduled{false};
+
+    // single producer (serialized by m_mutex), single consumer (pd thread)
+    ParameterMessageQueue m_messages;
 };
 
 } // namespace rcp
@@ -0,0 +1,394 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#include "ParameterState.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <rcp.h>
+
+static const char STATE_MAGIC[4] = { 'R', 'C', 'P', 'S' };
+
+static const uint8_t ALL_FLAGS = rcp::StateRecord::READONLY |
+                                 rcp::StateRecord::ORDER |
+                                 rcp::StateRecord::MIN |
+                                 rcp::StateRecord::MAX |
+                                 rcp::StateRecord::VALUE;
+
+static void putU8(std::vector<char>& data, uint8_t v)
+{
+    data.push_back((char)v);
+}
+
+static void putU16(std::vector<char>& data, uint16_t v)
+{
+    data.push_back((char)(v & 0xFF));
+    data.push_back((char)(v >> 8));
+}
+
+static void putU32(std::vector<char>& data, uint32_t v)
+{
+    for (int i=0; i<4; i++)
+    {
+        data.push_back((char)((v >> (i * 8)) & 0xFF));
+    }
+}
+
+static void putNumber(std::vector<char>& data, const rcp::StateRecord::Number& n)
+{
+    uint32_t v;
+    memcpy(&v, &n, sizeof(v));
+    putU32(data, v);
+}
+
+// bounds checked reader
+class StateReader
+{
+public:
+    StateReader(const char* data, size_t size)
+        : m_pos(data)
+        , m_end(data + size)
+    {}
+
+    bool u8(uint8_t& v)
+    {
+        if (m_end - m_pos < 1) return false;
+        v = (uint8_t)*m_pos++;
+        return true;
+    }
+
+    bool u16(uint16_t& v)
+    {
+        if (m_end - m_pos < 2) return false;
+        v = (uint16_t)((uint8_t)m_pos[0] | ((uint8_t)m_pos[1] << 8));
+        m_pos += 2;
+        return true;
+    }
+
+    bool u32(uint32_t& v)
+    {
+        if (m_end - m_pos < 4) return false;
+        v = 0;
+        for (int i=0; i<4; i++)
+        {
+            v |= (uint32_t)(uint8_t)m_pos[i] << (i * 8);
+        }
+        m_pos += 4;
+        return true;
+    }
+
+    bool number(rcp::StateRecord::Number& n)
+    {
+        uint32_t v;
+        if (!u32(v)) return false;
+        memcpy(&n, &v, sizeof(v));
+        return true;
+    }
+
+    bool bytes(std::string& s, size_t size)
+    {
+        if ((size_t)(m_end - m_pos) < size) return false;
+        s.assign(m_pos, size);
+        m_pos += size;
+        return true;
+    }
+
+    size_t remaining() const
+    {
+        return m_end - m_pos;
+    }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+
+namespace rcp
+{
+
+std::vector<StateRecord>& ParameterState::records()
+{
+    return m_records;
+}
+
+const std::vector<StateRecord>& ParameterState::records() const
+{
+    return m_records;
+}
+
+bool ParameterState::write(const std::string& filename)
+{
+    m_error.clear();
+
+    std::vector<char> data;
+    encode(data);
+
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!file)
+    {
+        m_error = "could not open " + filename;
+        return false;
+    }
+
+    file.write(data.data(), data.size());
+
+    if (!file)
+    {
+        m_error = "could not write " + filename;
+        return false;
+    }
+
+    return true;
+}
+
+bool ParameterState::read(const std::string& filename)
+{
+    m_records.clear();
+    m_error.clear();
+
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+
+    if (!file)
+    {
+        m_error = "could not open " + filename;
+        return false;
+    }
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+
+    return decode(data.data(), data.size());
+}
+
+const std::string& ParameterState::error() const
+{
+    return m_error;
+}
+
+void ParameterState::encode(std::vector<char>& data) const
+{
+    data.insert(data.end(), STATE_MAGIC, STATE_MAGIC + 4);
+    putU16(data, VERSION);
+    putU16(data, 0);
+    putU32(data, (uint32_t)m_records.size());
+
+    for (size_t i=0; i<m_records.size(); i++)
+    {
+        const StateRecord& r = m_records[i];
+
+        putU8(data, r.type);
+        putU8(data, r.flags);
+        putU32(data, (uint32_t)r.parent);
+
+        uint16_t label_size = (uint16_t)std::min<size_t>(r.label.size(), 0xFFFF);
+        putU16(data, label_size);
+        data.insert(data.end(), r.label.begin(), r.label.begin() + label_size);
+
+        if (r.flags & StateRecord::ORDER) putU32(data, (uint32_t)r.order);
+        if (r.flags & StateRecord::MIN) putNumber(data, r.min);
+        if (r.flags & StateRecord::MAX) putNumber(data, r.max);
+
+        if (r.flags & StateRecord::VALUE)
+        {
+            switch (r.type)
+            {
+            case DATATYPE_BOOLEAN:
+                putU8(data, r.boolean ? 1 : 0);
+                break;
+            case DATATYPE_INT32:
+            case DATATYPE_FLOAT32:
+                putNumber(data, r.number);
+                break;
+            case DATATYPE_STRING:
+                putU32(data, (uint32_t)r.string.size());
+                data.insert(data.end(), r.string.begin(), r.string.end());
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+bool ParameterState::decode(const char* data, size_t size)
+{
+    m_records.clear();
+    m_error.clear();
+
+    if (!decodeRecords(data, size))
+    {
+        m_records.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool ParameterState::decodeRecords(const char* data, size_t size)
+{
+    if (size < 12 ||
+        memcmp(data, STATE_MAGIC, 4) != 0)
+    {
+        m_error = "not a state file";
+        return false;
+    }
+
+    StateReader reader(data + 4, size - 4);
+
+    uint16_t version = 0;
+    uint16_t reserved = 0;
+    uint32_t count = 0;
+    reader.u16(version);
+    reader.u16(reserved);
+    reader.u32(count);
+
+    if (version != VERSION)
+    {
+        m_error = "unsupported state version";
+        return false;
+    }
+
+    // a record takes at least 8 bytes
+    if (count > reader.remaining() / 8)
+    {
+        m_error = "invalid record count";
+        return false;
+    }
+
+    m_records.resize(count);
+
+    for (uint32_t i=0; i<count; i++)
+    {
+        StateRecord& r = m_records[i];
+
+        uint32_t parent = 0;
+        uint16_t label_size = 0;
+
+        if (!reader.u8(r.type) ||
+            !reader.u8(r.flags) ||
+            !reader.u32(parent) ||
+            !reader.u16(label_size) ||
+            !reader.bytes(r.label, label_size))
+        {
+            m_error = "truncated state file";
+            return false;
+        }
+
+        switch (r.type)
+        {
+        case DATATYPE_GROUP:
+        case DATATYPE_BANG:
+        case DATATYPE_BOOLEAN:
+        case DATATYPE_INT32:
+        case DATATYPE_FLOAT32:
+        case DATATYPE_STRING:
+            break;
+        default:
+            m_error = "invalid type in state file";
+            return false;
+        }
+
+        if (r.flags & ~ALL_FLAGS)
+        {
+            m_error = "invalid flags in state file";
+            return false;
+        }
+
+        r.parent = (int32_t)parent;
+
+        // parents are written first
+        if (r.parent >= (int32_t)i ||
+            r.parent < -1 ||
+            (r.parent >= 0 && m_records[r.parent].type != DATATYPE_GROUP))
+        {
+            m_error = "invalid parent in state file";
+            return false;
+        }
+
+        bool ok = true;
+
+        if (r.flags & StateRecord::ORDER)
+        {
+            uint32_t order = 0;
+            ok = ok && reader.u32(order);
+            r.order = (int32_t)order;
+        }
+        if (r.flags & StateRecord::MIN) ok = ok && reader.number(r.min);
+        if (r.flags & StateRecord::MAX) ok = ok && reader.number(r.max);
+
+        if (r.flags & StateRecord::VALUE)
+        {
+            switch (r.type)
+            {
+            case DATATYPE_BOOLEAN:
+            {
+                uint8_t b = 0;
+                ok = ok && reader.u8(b);
+                r.boolean = b != 0;
+                break;
+            }
+            case DATATYPE_INT32:
+            case DATATYPE_FLOAT32:
+                ok = ok && reader.number(r.number);
+                break;
+            case DATATYPE_STRING:
+            {
+                uint32_t string_size = 0;
+                ok = ok && reader.u32(string_size) && reader.bytes(r.string, string_size);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        if (!ok)
+        {
+            m_error = "truncated state file";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace rcp
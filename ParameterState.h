@@ -0,0 +1,126 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#ifndef RCP_PARAMETERSTATE_H
+#define RCP_PARAMETERSTATE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rcp
+{
+
+// one parameter of a state image
+struct StateRecord
+{
+    enum Flags
+    {
+        READONLY = 0x01,
+        ORDER = 0x02,
+        MIN = 0x04,
+        MAX = 0x08,
+        VALUE = 0x10
+    };
+
+    // int32 or float32 - depending on type
+    union Number
+    {
+        int32_t i;
+        float f;
+    };
+
+    StateRecord()
+    {
+        min.i = 0;
+        max.i = 0;
+        number.i = 0;
+    }
+
+    // rcp_datatype
+    uint8_t type{0};
+    uint8_t flags{0};
+    // index of the parent group record, -1 for root
+    int32_t parent{-1};
+    std::string label;
+
+    int32_t order{0};
+    Number min;
+    Number max;
+
+    // value
+    Number number;
+    bool boolean{false};
+    std::string string;
+};
+
+// binary image of a parameter tree: structure, options and values
+//
+// header: "RCPS" <uint16 version> <uint16 reserved> <uint32 record count>
+// record: <uint8 type> <uint8 flags> <int32 parent> <uint16 label length> <label>
+//         [int32 order] [min] [max] [value]
+//
+// numbers are little endian, min, max and number values take 4 bytes,
+// booleans 1 byte, strings <uint32 length> <bytes>
+// a parent record always comes before its children
+class ParameterState
+{
+public:
+    static const uint16_t VERSION = 1;
+
+    std::vector<StateRecord>& records();
+    const std::vector<StateRecord>& records() const;
+
+    bool write(const std::string& filename);
+    bool read(const std::string& filename);
+
+    // the file image - used by write() and read()
+    void encode(std::vector<char>& data) const;
+    bool decode(const char* data, size_t size);
+
+    const std::string& error() const;
+
+private:
+    bool decodeRecords(const char* data, size_t size);
+
+    std::vector<StateRecord> m_records;
+    std::string m_error;
+};
+
+} // namespace rcp
+
+#endif // RCP_PARAMETERSTATE_H
@@ -95,7 +95,8 @@ void PdClientTransporter::pushData(const char* data, size_t size) const
         data &&
         size > 0)
     {
-        // NOTE: no need to lock
+        // NOTE: keep producers of the parameter message queue serialized
+        Threading::TimedLock lock(m_pdClient->mutex(), LOCK_SITE_RECEIVED);
 
         rcp_client_transporter_call_recv_cb(m_transporter, data, size);
     }
@@ -41,10 +41,20 @@
 #include <rcp_memory.h>
 #include <rcp_server.h>
 
+#include "ParameterServer.h"
+#include "PdMaxUtils.h"
 #include "Threading.h"
 
 #include "rabbit.server.h"
 
+using namespace PdMaxUtils;
+
+struct RawOverflow
+{
+    rcp::PdServerTransporter* owner;
+    std::string data;
+};
+
 
 static void pd_server_transporter_sendToOne(rcp_server_transporter* transporter, const char* data, size_t data_size, void* /*clientId*/)
 {
@@ -66,11 +76,38 @@ static void pd_server_transporter_sendToAll(rcp_server_transporter* transporter,
     }
 }
 
+static void pd_raw_data_output(t_pd *obj, void *data)
+{
+    if (obj != NULL &&
+        data != NULL)
+    {
+        ((rcp::PdServerTransporter*)data)->outputQueued();
+    }
+}
+
+static void pd_raw_overflow_output(t_pd *obj, void *data)
+{
+    RawOverflow* overflow = (RawOverflow*)data;
+
+    if (obj != NULL &&
+        overflow != NULL)
+    {
+        overflow->owner->outputOverflow(overflow->data);
+    }
+
+    if (overflow)
+    {
+        delete overflow;
+    }
+}
+
 namespace rcp {
 
 
-PdServerTransporter::PdServerTransporter(t_pd* x)
+PdServerTransporter::PdServerTransporter(t_pd* x, Threading::Mutex& mutex)
     : m_x(x)
+    , m_mutex(mutex)
+    , m_ring(RCP_RAW_RING_SIZE)
 {
     m_transporter = (rcp_server_transporter*)RCP_CALLOC(1, sizeof (rcp_server_transporter));
 
@@ -96,9 +133,93 @@ PdServerTransporter::~PdServerTransporter()
 void PdServerTransporter::rawOut(const char* data, size_t size)
 {
     // can be on a thread
-    auto str = new std::string(data, size);
+    // NOTE: rcp calls this with the instance lock held, which serializes producers
+
+    uint32_t packet_size = size;
+
+    if (m_overflowPending.load() == 0 &&
+        m_ring.push((const char*)&packet_size, sizeof(packet_size), data, size))
+    {
+        m_packetsQueued++;
+        m_bytesQueued += size;
+
+        // one drain per tick
+        if (!m_scheduled.exchange(true))
+        {
+            pd_queue_mess(&pd_maininstance, m_x, this, pd_raw_data_output);
+        }
+
+        return;
+    }
+
+    // ring is full or packet does not fit - send it on its own
+    m_packetsOverflowed++;
+    m_bytesOverflowed += size;
+    m_overflowPending++;
+
+    RawOverflow* overflow = new RawOverflow();
+    overflow->owner = this;
+    overflow->data.assign(data, size);
+
+    pd_queue_mess(&pd_maininstance, m_x, overflow, pd_raw_overflow_output);
+}
+
+void PdServerTransporter::outputQueued()
+{
+    m_scheduled = false;
+
+    // only output what is here now - later packets schedule a new drain
+    size_t available = m_ring.size();
+
+    while (available >= sizeof(uint32_t))
+    {
+        uint32_t packet_size = 0;
+        m_ring.pop((char*)&packet_size, sizeof(packet_size));
+
+        m_packet.resize(packet_size);
+        m_ring.pop(m_packet.data(), packet_size);
+
+        available -= sizeof(packet_size) + packet_size;
+
+        output(m_packet.data(), packet_size);
+    }
+}
+
+void PdServerTransporter::outputOverflow(const std::string& data)
+{
+    output(data.data(), data.size());
+    m_overflowPending--;
+}
+
+void PdServerTransporter::output(const char* data, size_t size)
+{
+    t_rabbit_server_pd* x = (t_rabbit_server_pd*)m_x;
+
+    if (x->parameter_server)
+    {
+        x->parameter_server->dataOut(data, size);
+    }
+}
+
+void PdServerTransporter::memoryUsage(size_t& queuedBytes, size_t& payloads) const
+{
+    queuedBytes = m_ring.size();
+    payloads = m_overflowPending;
+}
+
+void PdServerTransporter::outputStats(t_outlet* outlet) const
+{
+    // rawstats <pending bytes> <capacity> <packets> <bytes> <overflowed packets> <overflowed bytes>
+    t_atom list[6];
+
+    setInt(list[0], m_ring.size());
+    setInt(list[1], m_ring.capacity());
+    setFloat(list[2], m_packetsQueued.load());
+    setFloat(list[3], m_bytesQueued.load());
+    setFloat(list[4], m_packetsOverflowed.load());
+    setFloat(list[5], m_bytesOverflowed.load());
 
-    pd_queue_mess(&pd_maininstance, m_x, str, pd_raw_data_out);
+    outlet_anything(outlet, gensym("rawstats"), 6, list);
 }
 
 rcp_server_transporter* PdServerTransporter::transporter() const
@@ -112,7 +233,7 @@ void PdServerTransporter::pushData(const char* data, size_t size) const
         data  &&
         size > 0)
     {
-        std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+        Threading::TimedLock lock(m_mutex, LOCK_SITE_RECEIVED);
 
         rcp_server_transporter_call_recv_cb(m_transporter, data, size, NULL);
     }
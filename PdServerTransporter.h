@@ -38,11 +38,20 @@
 #ifndef PDSERVERTRANSPORTER_H
 #define PDSERVERTRANSPORTER_H
 
+#include <atomic>
+#include <string>
+#include <vector>
+
 #include <rcp_server_transporter.h>
 
 #include <m_pd.h>
 
 #include "IServerTransporter.h"
+#include "SpscRing.h"
+#include "Threading.h"
+
+// bytes of raw output buffered between the rcp thread and the pd thread
+#define RCP_RAW_RING_SIZE 65536
 
 namespace rcp
 {
@@ -52,11 +61,16 @@ class ParameterServer;
 class PdServerTransporter : public IServerTransporter
 {
 public:
-    PdServerTransporter(t_pd* x);
+    PdServerTransporter(t_pd* x, Threading::Mutex& mutex);
     ~PdServerTransporter();
 
     void rawOut(const char* data, size_t data_size);
 
+    // pd thread
+    void outputQueued();
+    void outputOverflow(const std::string& data);
+    void outputStats(t_outlet* outlet) const;
+
 public:
     // IServerTransporter
     rcp_server_transporter* transporter() const override;
@@ -66,10 +80,26 @@ public:
     uint16_t port() const override { return 0; }
     bool isListening() const override { return true; }
     size_t clientCount() const override { return 0; }
+    void memoryUsage(size_t& queuedBytes, size_t& payloads) const override;
+
+private:
+    void output(const char* data, size_t size);
 
 private:    
     t_pd* m_x{nullptr};
+    Threading::Mutex& m_mutex;
     rcp_server_transporter* m_transporter{nullptr};
+
+    // packets as: size (uint32_t) data
+    SpscRing<char> m_ring;
+    std::vector<char> m_packet;
+    std::atomic<bool> m_scheduled{false};
+    std::atomic<uint32_t> m_overflowPending{0};
+
+    std::atomic<uint32_t> m_packetsQueued{0};
+    std::atomic<uint32_t> m_bytesQueued{0};
+    std::atomic<uint32_t> m_packetsOverflowed{0};
+    std::atomic<uint32_t> m_bytesOverflowed{0};
 };
 
 } // namespace rcp
@@ -71,10 +71,11 @@ static void _rhl_connection_timer(rcp::RabbitHoleServerTransporter* transporter)
 namespace rcp
 {
 
-RabbitHoleServerTransporter::RabbitHoleServerTransporter(t_pd* x, rcp_server* server)
+RabbitHoleServerTransporter::RabbitHoleServerTransporter(t_pd* x, rcp_server* server, Threading::Mutex& mutex)
     : WebsocketClient()
     , m_x(x)
     , m_rcpServer(server)
+    , m_mutex(mutex)
 {
     // make sure it sends in binary
     binary(true);
@@ -116,14 +117,11 @@ RabbitHoleServerTransporter::~RabbitHoleServerTransporter()
 
 void RabbitHoleServerTransporter::send(const char* data, size_t data_size)
 {
-    std::vector<char> d;
+    std::lock_guard<std::mutex> lock(m_sendMutex);
 
-    for (size_t i=0; i<data_size; i++)
-    {
-        d.push_back(data[i]);
-    }
+    m_sendBuffer.assign(data, data + data_size);
 
-    WebsocketClient::send(d);
+    WebsocketClient::send(m_sendBuffer);
 }
 
 void RabbitHoleServerTransporter::connected()
@@ -156,7 +154,7 @@ void RabbitHoleServerTransporter::received(const char* data, size_t size)
     {
         if (m_transporter->received)
         {
-            std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+            Threading::TimedLock lock(m_mutex, LOCK_SITE_RECEIVED);
 
             rcp_server_transporter_call_recv_cb(m_transporter, data, size, NULL);
         }
@@ -38,12 +38,17 @@
 #ifndef RABBITHOLESERVERTRANSPORTER_H
 #define RABBITHOLESERVERTRANSPORTER_H
 
+#include <mutex>
+#include <vector>
+
 #include <m_pd.h>
 
 #include <WebsocketClient.h>
 
 #include <rcp_server_transporter.h>
 
+#include "Threading.h"
+
 using namespace scaryws;
 
 namespace rcp {
@@ -52,7 +57,7 @@ class RabbitHoleServerTransporter
     : public WebsocketClient
 {
 public:
-    RabbitHoleServerTransporter(t_pd* x, rcp_server* server);
+    RabbitHoleServerTransporter(t_pd* x, rcp_server* server, Threading::Mutex& mutex);
     ~RabbitHoleServerTransporter();
 
     rcp_server_transporter* transporter() const;
@@ -71,9 +76,14 @@ public:
 private:
     t_pd* m_x{nullptr};
     rcp_server* m_rcpServer{nullptr};
+    Threading::Mutex& m_mutex;
 
     rcp_server_transporter* m_transporter{nullptr};
 
+    // reused for every send
+    std::mutex m_sendMutex;
+    std::vector<char> m_sendBuffer;
+
     // connection timer
     t_clock* m_connectionTimer{nullptr};
     int m_connectionInverval{2000};
@@ -0,0 +1,710 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#include "SchemaLoader.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <utility>
+
+namespace
+{
+
+struct JsonValue
+{
+    enum Type
+    {
+        NUL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    Type type{NUL};
+    // where the value starts - for error messages
+    int line{1};
+    bool boolean{false};
+    double number{0};
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue> > object;
+
+    const JsonValue* member(const char* key) const
+    {
+        for (size_t i=0; i<object.size(); i++)
+        {
+            if (object[i].first == key)
+            {
+                return &object[i].second;
+            }
+        }
+
+        return nullptr;
+    }
+};
+
+// small recursive descent json parser - enough for schema files
+class JsonParser
+{
+public:
+    JsonParser(const char* data, size_t size)
+        : m_data(data)
+        , m_end(data + size)
+        , m_pos(data)
+        , m_line(1)
+    {}
+
+    bool parse(JsonValue& value)
+    {
+        skipWhitespace();
+
+        if (!parseValue(value, 0))
+        {
+            return false;
+        }
+
+        skipWhitespace();
+
+        if (m_pos != m_end)
+        {
+            return fail("unexpected data after end");
+        }
+
+        return true;
+    }
+
+    const std::string& error() const
+    {
+        return m_error;
+    }
+
+private:
+    // guard against stack overflow from malicious nesting
+    static const int MAX_DEPTH = 128;
+
+    bool fail(const char* message)
+    {
+        int line = 1;
+        for (const char* p=m_data; p<m_pos && p<m_end; p++)
+        {
+            if (*p == '\n') line++;
+        }
+
+        std::ostringstream ss;
+        ss << message << " (line " << line << ")";
+        m_error = ss.str();
+
+        return false;
+    }
+
+    void skipWhitespace()
+    {
+        while (m_pos < m_end &&
+               (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r'))
+        {
+            if (*m_pos == '\n') m_line++;
+            m_pos++;
+        }
+    }
+
+    bool literal(const char* word)
+    {
+        const char* p = m_pos;
+        while (*word)
+        {
+            if (p >= m_end || *p != *word)
+            {
+                return false;
+            }
+            p++;
+            word++;
+        }
+
+        m_pos = p;
+        return true;
+    }
+
+    bool parseValue(JsonValue& value, int depth)
+    {
+        if (depth > MAX_DEPTH)
+        {
+            return fail("nesting too deep");
+        }
+
+        value.line = m_line;
+
+        if (m_pos >= m_end)
+        {
+            return fail("unexpected end");
+        }
+
+        switch (*m_pos)
+        {
+        case '{':
+            return parseObject(value, depth);
+        case '[':
+            return parseArray(value, depth);
+        case '"':
+            value.type = JsonValue::STRING;
+            return parseString(value.string);
+        case 't':
+            if (!literal("true")) return fail("invalid literal");
+            value.type = JsonValue::BOOLEAN;
+            value.boolean = true;
+            return true;
+        case 'f':
+            if (!literal("false")) return fail("invalid literal");
+            value.type = JsonValue::BOOLEAN;
+            value.boolean = false;
+            return true;
+        case 'n':
+            if (!literal("null")) return fail("invalid literal");
+            value.type = JsonValue::NUL;
+            return true;
+        default:
+            return parseNumber(value);
+        }
+    }
+
+    bool parseObject(JsonValue& value, int depth)
+    {
+        value.type = JsonValue::OBJECT;
+
+        // skip {
+        m_pos++;
+        skipWhitespace();
+
+        if (m_pos < m_end && *m_pos == '}')
+        {
+            m_pos++;
+            return true;
+        }
+
+        while (true)
+        {
+            skipWhitespace();
+
+            if (m_pos >= m_end || *m_pos != '"')
+            {
+                return fail("expected key");
+            }
+
+            value.object.push_back(std::make_pair(std::string(), JsonValue()));
+
+            if (!parseString(value.object.back().first))
+            {
+                return false;
+            }
+
+            skipWhitespace();
+
+            if (m_pos >= m_end || *m_pos != ':')
+            {
+                return fail("expected ':'");
+            }
+            m_pos++;
+
+            skipWhitespace();
+
+            if (!parseValue(value.object.back().second, depth + 1))
+            {
+                return false;
+            }
+
+            skipWhitespace();
+
+            if (m_pos < m_end && *m_pos == ',')
+            {
+                m_pos++;
+                continue;
+            }
+
+            if (m_pos < m_end && *m_pos == '}')
+            {
+                m_pos++;
+                return true;
+            }
+
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    bool parseArray(JsonValue& value, int depth)
+    {
+        value.type = JsonValue::ARRAY;
+
+        // skip [
+        m_pos++;
+        skipWhitespace();
+
+        if (m_pos < m_end && *m_pos == ']')
+        {
+            m_pos++;
+            return true;
+        }
+
+        while (true)
+        {
+            skipWhitespace();
+
+            value.array.push_back(JsonValue());
+
+            if (!parseValue(value.array.back(), depth + 1))
+            {
+                return false;
+            }
+
+            skipWhitespace();
+
+            if (m_pos < m_end && *m_pos == ',')
+            {
+                m_pos++;
+                continue;
+            }
+
+            if (m_pos < m_end && *m_pos == ']')
+            {
+                m_pos++;
+                return true;
+            }
+
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    bool parseHex4(unsigned int& code)
+    {
+        if (m_end - m_pos < 4)
+        {
+            return fail("invalid unicode escape");
+        }
+
+        code = 0;
+        for (int i=0; i<4; i++)
+        {
+            char c = *m_pos++;
+            code <<= 4;
+
+            if (c >= '0' && c <= '9') code |= (unsigned int)(c - '0');
+            else if (c >= 'a' && c <= 'f') code |= (unsigned int)(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') code |= (unsigned int)(c - 'A' + 10);
+            else return fail("invalid unicode escape");
+        }
+
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, unsigned int code)
+    {
+        if (code < 0x80)
+        {
+            out += (char)code;
+        }
+        else if (code < 0x800)
+        {
+            out += (char)(0xC0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            out += (char)(0xE0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            out += (char)(0xF0 | (code >> 18));
+            out += (char)(0x80 | ((code >> 12) & 0x3F));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+    }
+
+    bool parseString(std::string& out)
+    {
+        // skip "
+        m_pos++;
+
+        while (m_pos < m_end)
+        {
+            char c = *m_pos++;
+
+            if (c == '"')
+            {
+                return true;
+            }
+
+            if (c != '\\')
+            {
+                if (c == '\n') m_line++;
+                out += c;
+                continue;
+            }
+
+            if (m_pos >= m_end)
+            {
+                break;
+            }
+
+            c = *m_pos++;
+
+            switch (c)
+            {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u':
+            {
+                unsigned int code = 0;
+                if (!parseHex4(code))
+                {
+                    return false;
+                }
+
+                if (code >= 0xDC00 && code <= 0xDFFF)
+                {
+                    return fail("lone low surrogate");
+                }
+
+                // surrogate pair
+                if (code >= 0xD800 && code <= 0xDBFF)
+                {
+                    if (m_end - m_pos < 6 ||
+                        m_pos[0] != '\\' || m_pos[1] != 'u')
+                    {
+                        return fail("lone high surrogate");
+                    }
+
+                    m_pos += 2;
+
+                    unsigned int low = 0;
+                    if (!parseHex4(low))
+                    {
+                        return false;
+                    }
+
+                    if (low < 0xDC00 || low > 0xDFFF)
+                    {
+                        return fail("invalid low surrogate");
+                    }
+
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return fail("invalid escape");
+            }
+        }
+
+        return fail("unterminated string");
+    }
+
+    bool parseNumber(JsonValue& value)
+    {
+        const char* start = m_pos;
+
+        while (m_pos < m_end &&
+               ((*m_pos >= '0' && *m_pos <= '9') ||
+                *m_pos == '-' || *m_pos == '+' ||
+                *m_pos == '.' || *m_pos == 'e' || *m_pos == 'E'))
+        {
+            m_pos++;
+        }
+
+        if (m_pos == start)
+        {
+            return fail("unexpected character");
+        }
+
+        std::string number(start, m_pos);
+        char* end = nullptr;
+        value.number = strtod(number.c_str(), &end);
+
+        if (end == nullptr ||
+            *end != 0)
+        {
+            m_pos = start;
+            return fail("invalid number");
+        }
+
+        value.type = JsonValue::NUMBER;
+        return true;
+    }
+
+private:
+    const char* m_data;
+    const char* m_end;
+    const char* m_pos;
+    int m_line;
+    std::string m_error;
+};
+
+
+bool readNodes(const JsonValue& array, std::vector<rcp::SchemaNode>& nodes, size_t& count, std::string& error);
+
+// out of range casts are undefined
+double clamp(double value, double min, double max)
+{
+    return std::max(min, std::min(max, value));
+}
+
+std::string atLine(const JsonValue& value)
+{
+    std::ostringstream ss;
+    ss << " (line " << value.line << ")";
+    return ss.str();
+}
+
+// exact type names - stored as "group" or the one letter expose takes
+bool canonicalType(const std::string& name, std::string& type)
+{
+    static const char* names[][2] = {
+        { "group", "group" },
+        { "f", "f" }, { "float", "f" },
+        { "i", "i" }, { "int", "i" },
+        { "t", "t" }, { "toggle", "t" }, { "bool", "t" },
+        { "b", "b" }, { "bang", "b" },
+        { "s", "s" }, { "string", "s" },
+    };
+
+    for (size_t i=0; i<sizeof(names)/sizeof(names[0]); i++)
+    {
+        if (name == names[i][0])
+        {
+            type = names[i][1];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool readNode(const JsonValue& entry, rcp::SchemaNode& node, size_t& count, std::string& error)
+{
+    if (entry.type != JsonValue::OBJECT)
+    {
+        error = "parameter entry is not an object" + atLine(entry);
+        return false;
+    }
+
+    const JsonValue* label = entry.member("label");
+    if (label == nullptr ||
+        label->type != JsonValue::STRING ||
+        label->string.empty())
+    {
+        error = "parameter entry without label" + atLine(entry);
+        return false;
+    }
+
+    node.label = label->string;
+
+    const JsonValue* type = entry.member("type");
+    if (type != nullptr)
+    {
+        if (type->type != JsonValue::STRING ||
+            !canonicalType(type->string, node.type))
+        {
+            error = "unknown type of '" + node.label + "'" + atLine(*type);
+            return false;
+        }
+    }
+
+    const JsonValue* v = entry.member("min");
+    if (v != nullptr && v->type == JsonValue::NUMBER) node.min.set((float)clamp(v->number, -FLT_MAX, FLT_MAX));
+
+    v = entry.member("max");
+    if (v != nullptr && v->type == JsonValue::NUMBER) node.max.set((float)clamp(v->number, -FLT_MAX, FLT_MAX));
+
+    v = entry.member("order");
+    if (v != nullptr && v->type == JsonValue::NUMBER) node.order.set((int)clamp(v->number, INT32_MIN, INT32_MAX));
+
+    v = entry.member("readonly");
+    if (v != nullptr && v->type == JsonValue::BOOLEAN) node.readonly.set(v->boolean);
+
+    v = entry.member("value");
+    if (v != nullptr)
+    {
+        if (v->type == JsonValue::NUMBER) node.number.set(v->number);
+        else if (v->type == JsonValue::BOOLEAN) node.number.set(v->boolean ? 1 : 0);
+        else if (v->type == JsonValue::STRING) node.string.set(v->string);
+    }
+
+    count++;
+
+    const JsonValue* children = entry.member("children");
+    if (children != nullptr)
+    {
+        if (children->type != JsonValue::ARRAY)
+        {
+            error = "children of '" + node.label + "' is not an array" + atLine(*children);
+            return false;
+        }
+
+        if (node.type.empty())
+        {
+            node.type = "group";
+        }
+        else if (!node.isGroup())
+        {
+            error = "parameter '" + node.label + "' of type '" + type->string + "' has children" + atLine(*children);
+            return false;
+        }
+
+        return readNodes(*children, node.children, count, error);
+    }
+
+    if (node.type.empty())
+    {
+        error = "parameter '" + node.label + "' without type" + atLine(entry);
+        return false;
+    }
+
+    return true;
+}
+
+bool readNodes(const JsonValue& array, std::vector<rcp::SchemaNode>& nodes, size_t& count, std::string& error)
+{
+    nodes.resize(array.array.size());
+
+    for (size_t i=0; i<array.array.size(); i++)
+    {
+        if (!readNode(array.array[i], nodes[i], count, error))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+
+namespace rcp
+{
+
+bool SchemaNode::isGroup() const
+{
+    return type == "group";
+}
+
+
+bool SchemaLoader::load(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+
+    if (!file)
+    {
+        m_error = "could not open " + filename;
+        return false;
+    }
+
+    std::string data((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+
+    return parse(data.data(), data.size());
+}
+
+bool SchemaLoader::parse(const char* data, size_t size)
+{
+    m_nodes.clear();
+    m_count = 0;
+    m_error.clear();
+
+    JsonValue root;
+    JsonParser parser(data, size);
+
+    if (!parser.parse(root))
+    {
+        m_error = parser.error();
+        return false;
+    }
+
+    const JsonValue* parameters = &root;
+    if (root.type == JsonValue::OBJECT)
+    {
+        parameters = root.member("parameters");
+    }
+
+    if (parameters == nullptr ||
+        parameters->type != JsonValue::ARRAY)
+    {
+        m_error = "no parameter array found";
+        return false;
+    }
+
+    if (!readNodes(*parameters, m_nodes, m_count, m_error))
+    {
+        m_nodes.clear();
+        m_count = 0;
+        return false;
+    }
+
+    return true;
+}
+
+const std::vector<SchemaNode>& SchemaLoader::nodes() const
+{
+    return m_nodes;
+}
+
+size_t SchemaLoader::count() const
+{
+    return m_count;
+}
+
+const std::string& SchemaLoader::error() const
+{
+    return m_error;
+}
+
+} // namespace rcp
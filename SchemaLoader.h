@@ -0,0 +1,106 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#ifndef RCP_SCHEMALOADER_H
+#define RCP_SCHEMALOADER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Optional.h"
+
+namespace rcp
+{
+
+// one entry of a parameter schema
+struct SchemaNode
+{
+    std::string label;
+    // "group" or a type as in expose: f, i, t, b, s
+    // the file may also use float, int, toggle, bool, bang, string
+    std::string type;
+
+    Optional<float> min;
+    Optional<float> max;
+    Optional<int> order;
+    Optional<bool> readonly;
+
+    // initial value - booleans are read as number
+    Optional<double> number;
+    Optional<std::string> string;
+
+    std::vector<SchemaNode> children;
+
+    bool isGroup() const;
+};
+
+// read a parameter tree from a json file
+//
+// {
+//   "parameters": [
+//     { "label": "fx", "type": "group", "children": [
+//       { "label": "mix", "type": "f", "min": 0, "max": 1, "value": 0.5 },
+//       { "label": "bypass", "type": "t", "readonly": true }
+//     ]}
+//   ]
+// }
+//
+// the top level may also be the parameter array itself
+// an entry with children is a group, its type can be omitted
+// children on any other type are an error
+class SchemaLoader
+{
+public:
+    bool load(const std::string& filename);
+    bool parse(const char* data, size_t size);
+
+    const std::vector<SchemaNode>& nodes() const;
+    // number of entries including groups
+    size_t count() const;
+
+    const std::string& error() const;
+
+private:
+    std::vector<SchemaNode> m_nodes;
+    size_t m_count{0};
+    std::string m_error;
+};
+
+} // namespace rcp
+
+#endif // RCP_SCHEMALOADER_H
@@ -0,0 +1,163 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+#ifndef RCP_SPSCRING_H
+#define RCP_SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace rcp
+{
+
+// bounded lock-free ring for exactly one producer and one consumer thread
+// capacity is rounded up to a power of two
+template <class type>
+class SpscRing
+{
+public:
+    SpscRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        m_buffer.resize(size);
+        m_mask = size - 1;
+    }
+
+    // producer
+    bool push(const type& v)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+        {
+            // full
+            return false;
+        }
+
+        m_buffer[tail & m_mask] = v;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // producer - push both spans as one, or nothing
+    bool push(const type* a, size_t countA, const type* b, size_t countB)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t count = countA + countB;
+
+        if (m_buffer.size() - (tail - m_head.load(std::memory_order_acquire)) < count)
+        {
+            // not enough room
+            return false;
+        }
+
+        for (size_t i=0; i<countA; i++)
+        {
+            m_buffer[(tail + i) & m_mask] = a[i];
+        }
+
+        for (size_t i=0; i<countB; i++)
+        {
+            m_buffer[(tail + countA + i) & m_mask] = b[i];
+        }
+
+        m_tail.store(tail + count, std::memory_order_release);
+        return true;
+    }
+
+    // consumer - copy out and release count elements, all must be available
+    void pop(type* v, size_t count)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+
+        for (size_t i=0; i<count; i++)
+        {
+            v[i] = m_buffer[(head + i) & m_mask];
+        }
+
+        m_head.store(head + count, std::memory_order_release);
+    }
+
+    // consumer - oldest element or nullptr
+    type* front()
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        return &m_buffer[head & m_mask];
+    }
+
+    // consumer - release the element returned by front()
+    void pop()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // any thread - a snapshot
+    size_t size() const
+    {
+        // head first: it never passes the tail read after it
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+
+    size_t capacity() const
+    {
+        return m_buffer.size();
+    }
+
+private:
+    std::vector<type> m_buffer;
+    size_t m_mask{0};
+
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+};
+
+} // namespace rcp
+
+#endif // RCP_SPSCRING_H
@@ -40,7 +40,19 @@
 namespace rcp
 {
 
-std::recursive_mutex Threading::mutex;
+void RecursiveMutex::lock()
+{
+    m_mutex.lock();
+}
 
-} // namespace rcp
+void RecursiveMutex::unlock()
+{
+    m_mutex.unlock();
+}
 
+bool RecursiveMutex::try_lock()
+{
+    return m_mutex.try_lock();
+}
+
+} // namespace rcp
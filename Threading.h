@@ -38,15 +38,92 @@
 #ifndef RCP_THREADING_H
 #define RCP_THREADING_H
 
+#include <chrono>
 #include <mutex>
 
+#include "LockStats.h"
+
 namespace rcp
 {
 
+// recursive mutex with lock statistics
+// readers and writers take it alike: the pd thread is the only reader,
+// a shared mode would never overlap with anything
+class RecursiveMutex
+{
+public:
+    void lock();
+    void unlock();
+    bool try_lock();
+
+    LockStats& stats()
+    {
+        return m_stats;
+    }
+
+private:
+    std::recursive_mutex m_mutex;
+    LockStats m_stats;
+};
+
+// exclusive lock recording wait- and hold-time for a call site
+template <class mutex_type>
+class TimedLockGuard
+{
+public:
+    TimedLockGuard(mutex_type& mutex, LockSite site)
+        : m_mutex(mutex)
+        , m_site(site)
+        , m_timed(mutex.stats().enabled())
+    {
+        if (m_timed)
+        {
+            m_start = std::chrono::steady_clock::now();
+            m_mutex.lock();
+            m_locked = std::chrono::steady_clock::now();
+        }
+        else
+        {
+            m_mutex.lock();
+        }
+    }
+
+    ~TimedLockGuard()
+    {
+        if (m_timed)
+        {
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            m_mutex.unlock();
+
+            m_mutex.stats().record(m_site,
+                                   std::chrono::duration_cast<std::chrono::microseconds>(m_locked - m_start).count(),
+                                   std::chrono::duration_cast<std::chrono::microseconds>(end - m_locked).count());
+        }
+        else
+        {
+            m_mutex.unlock();
+        }
+    }
+
+    TimedLockGuard(const TimedLockGuard&) = delete;
+    TimedLockGuard& operator=(const TimedLockGuard&) = delete;
+
+private:
+    mutex_type& m_mutex;
+    LockSite m_site;
+    bool m_timed;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_locked;
+};
+
 class Threading
 {
 public:
-    static std::recursive_mutex mutex;
+    // every server and client owns one mutex
+    // it guards the rcp_manager and all transporters feeding it
+    typedef RecursiveMutex Mutex;
+    typedef std::lock_guard<Mutex> Lock;
+    typedef TimedLockGuard<Mutex> TimedLock;
 };
 
 } // namespace rcp
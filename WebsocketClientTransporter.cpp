@@ -41,6 +41,8 @@
 
 #include <rcp_memory.h>
 
+#include "OutboundQueue.h"
+#include "ParameterClient.h"
 #include "Threading.h"
 #include "rabbit.client.h"
 
@@ -54,6 +56,14 @@ static void _pd_websocket_client_transporter_send(rcp_client_transporter* transp
     }
 }
 
+static void pd_websocket_client_flush(t_pd* obj, void* data)
+{
+    if (obj && data)
+    {
+        ((rcp::WebsocketClientTransporter*)data)->flush();
+    }
+}
+
 // synchronized from threaded transporter
 
 static void pd_client_connected(t_pd *obj, void *data)
@@ -81,9 +91,11 @@ static void pd_client_disconnected(t_pd *obj, void *data)
 namespace rcp
 {
 
-WebsocketClientTransporter::WebsocketClientTransporter(t_pd* x)
+WebsocketClientTransporter::WebsocketClientTransporter(t_pd* x, ParameterClient* client)
     : WebsocketClient()
     , m_x(x)
+    , m_client(client)
+    , m_mutex(client->mutex())
 {
     binary(true);
 
@@ -109,14 +121,60 @@ WebsocketClientTransporter::~WebsocketClientTransporter()
 
 void WebsocketClientTransporter::send(const char *data, size_t size)
 {
-    std::vector<char> d(size);
+    m_packetsSent++;
+
+    if (!m_batch)
+    {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+
+        if (m_sendBuffer.capacity() < size)
+        {
+            m_buffers++;
+        }
+
+        m_sendBuffer.assign(data, data + size);
+
+        WebsocketClient::send(m_sendBuffer);
+        m_framesSent++;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+
+        if (m_frames.empty() ||
+            m_frames.back().size() + size > RCP_BATCH_FRAME_SIZE)
+        {
+            m_frames.push_back(std::vector<char>());
+            m_buffers++;
+        }
+
+        m_frames.back().insert(m_frames.back().end(), data, data + size);
+    }
+
+    if (!m_flushScheduled.exchange(true))
+    {
+        pd_queue_mess(&pd_maininstance, (t_pd*)m_x, this, pd_websocket_client_flush);
+    }
+}
+
+void WebsocketClientTransporter::flush()
+{
+    m_flushScheduled = false;
+
+    std::vector<std::vector<char> > frames;
+
+    {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        frames.swap(m_frames);
+    }
 
-    for (int i = 0; i < size; ++i)
+    for (size_t i=0; i<frames.size(); i++)
     {
-        d[i] = data[i];
+        WebsocketClient::send(frames[i]);
     }
 
-    WebsocketClient::send(d);
+    m_framesSent += frames.size();
 }
 
 // IClientTransporter
@@ -135,6 +193,31 @@ void WebsocketClientTransporter::disconnect()
     WebsocketClient::disconnect();
 }
 
+void WebsocketClientTransporter::setBatch(bool batch)
+{
+    m_batch = batch;
+}
+
+void WebsocketClientTransporter::memoryUsage(size_t& queuedBytes, size_t& payloads) const
+{
+    std::lock_guard<std::mutex> lock(m_batchMutex);
+
+    queuedBytes = 0;
+    payloads = 0;
+
+    for (size_t i=0; i<m_frames.size(); i++)
+    {
+        queuedBytes += m_frames[i].size();
+    }
+}
+
+void WebsocketClientTransporter::sendStats(uint32_t& packets, uint32_t& frames, uint32_t& buffers) const
+{
+    packets = m_packetsSent;
+    frames = m_framesSent;
+    buffers = m_buffers;
+}
+
 
 // threaded
 void WebsocketClientTransporter::connected()
@@ -146,6 +229,10 @@ void WebsocketClientTransporter::connected()
 
 void WebsocketClientTransporter::disconnected(uint16_t code)
 {
+    // parameters of this connection are gone
+    // no lock here: disconnect() may wait for us with it held
+    m_client->invalidateParameterIndex();
+
     rcp_client_transporter_call_disconnected_cb(m_transporter);
 
     pd_queue_mess(&pd_maininstance, (t_pd*)m_x, NULL, pd_client_disconnected);
@@ -159,7 +246,7 @@ void WebsocketClientTransporter::received(const char* data, size_t size)
         data  &&
         size > 0)
     {
-        std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+        Threading::TimedLock lock(m_mutex, LOCK_SITE_RECEIVED);
 
         rcp_client_transporter_call_recv_cb(m_transporter, data, size);
     }
@@ -38,6 +38,10 @@
 #ifndef WEBSOCKETCLIENTTRANSPORTER_H
 #define WEBSOCKETCLIENTTRANSPORTER_H
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include <m_pd.h>
 
 #include <rcp_client_transporter.h>
@@ -45,27 +49,36 @@
 #include <WebsocketClient.h>
 
 #include "IClientTransporter.h"
+#include "Threading.h"
 
 using namespace scaryws;
 
 namespace rcp
 {
 
+class ParameterClient;
+
 class WebsocketClientTransporter
     : public WebsocketClient
     , public IClientTransporter
 {
 public:
-    WebsocketClientTransporter(t_pd* x);
+    WebsocketClientTransporter(t_pd* x, ParameterClient* client);
     ~WebsocketClientTransporter();
 
     void send(const char* data, size_t size);
 
+    // send batched frames - pd thread
+    void flush();
+
 public:
     // IClientTransporter
     rcp_client_transporter* transporter() const override;
     void connect(const std::string& address) override;
     void disconnect() override;
+    void setBatch(bool batch) override;
+    void sendStats(uint32_t& packets, uint32_t& frames, uint32_t& buffers) const override;
+    void memoryUsage(size_t& queuedBytes, size_t& payloads) const override;
 
 public:
     // IClientSessionListener
@@ -76,7 +89,24 @@ public:
 
 private:
     t_pd* m_x{nullptr};
+    ParameterClient* m_client{nullptr};
+    Threading::Mutex& m_mutex;
     rcp_client_transporter* m_transporter{nullptr};
+
+    // reused for unbatched sends
+    std::mutex m_sendMutex;
+    std::vector<char> m_sendBuffer;
+
+    // batch mode
+    std::atomic<bool> m_batch{false};
+    mutable std::mutex m_batchMutex;
+    std::vector<std::vector<char> > m_frames;
+    std::atomic<bool> m_flushScheduled{false};
+
+    std::atomic<uint32_t> m_packetsSent{0};
+    std::atomic<uint32_t> m_framesSent{0};
+    // send buffers allocated
+    std::atomic<uint32_t> m_buffers{0};
 };
 
 } // namespace rcp
@@ -37,8 +37,10 @@
 
 #include "WebsocketServerTransporter.h"
 
+#include <algorithm>
 #include <vector>
 
+#include <rcp.h>
 #include <rcp_memory.h>
 #include <rcp_server_transporter.h>
 
@@ -64,13 +66,27 @@ static void _pd_websocket_server_transporter_sendToAll(rcp_server_transporter* t
     }
 }
 
+static void pd_websocket_server_flush(t_pd* obj, void* data)
+{
+    if (obj && data)
+    {
+        ((rcp::WebsocketServerTransporter*)data)->flush();
+    }
+}
+
+static void _websocket_server_rate_clock_tick(rcp::WebsocketServerTransporter* x)
+{
+    x->flush();
+}
+
 
 namespace rcp
 {
 
-WebsocketServerTransporter::WebsocketServerTransporter(t_pd* x)
+WebsocketServerTransporter::WebsocketServerTransporter(t_pd* x, Threading::Mutex& mutex)
     : WebsocketServer()
     , m_x(x)
+    , m_mutex(mutex)
 {
     binary(true);
 
@@ -84,10 +100,19 @@ WebsocketServerTransporter::WebsocketServerTransporter(t_pd* x)
 
         m_transporter->user = this;
     }
+
+    m_rateClock = clock_new(this, (t_method)_websocket_server_rate_clock_tick);
+    m_lastFlush = clock_getlogicaltime();
 }
 
 WebsocketServerTransporter::~WebsocketServerTransporter()
 {
+    if (m_rateClock)
+    {
+        clock_free(m_rateClock);
+        m_rateClock = nullptr;
+    }
+
     if (m_transporter)
     {
         RCP_FREE(m_transporter);
@@ -97,25 +122,303 @@ WebsocketServerTransporter::~WebsocketServerTransporter()
 
 void WebsocketServerTransporter::sendToOne(const char *data, size_t size, void *id)
 {
-    std::vector<char> d(size);
+    bool queued = !sendDirect();
 
-    for (int i = 0; i < size; ++i)
+    if (!queued)
     {
-        d[i] = data[i];
+        // a client emptying its queue after the limits were removed keeps its order
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+
+        std::unordered_map<void*, ClientQueue>::iterator it = m_queues.find(id);
+        queued = it != m_queues.end() &&
+                (!it->second.queue.empty() || it->second.evicted);
+    }
+
+    if (!queued)
+    {
+        std::vector<char> d(data, data + size);
+        m_buffers++;
+
+        WebsocketServer::sendTo(d, id);
+
+        m_packetsSent++;
+        m_framesSent++;
+        return;
     }
 
-    WebsocketServer::sendTo(d, id);
+    SharedPacket packet = std::make_shared<std::vector<char> >(data, data + size);
+    m_buffers++;
+
+    bool found = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+
+        std::unordered_map<void*, ClientQueue>::iterator it = m_queues.find(id);
+        if (it != m_queues.end())
+        {
+            push(it->second, packet);
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        // client not (yet) known - send directly
+        WebsocketServer::sendTo(*packet, id);
+
+        m_packetsSent++;
+        m_framesSent++;
+        return;
+    }
+
+    scheduleFlush();
 }
 
 void WebsocketServerTransporter::sendToAll(const char *data, size_t size, void *excludeId)
 {
-    std::vector<char> d(size);
+    if (sendDirect())
+    {
+        bool queued = false;
+        size_t clients = 0;
 
-    for (int i = 0; i < size; ++i) {
-        d[i] = data[i];
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+
+            for (std::unordered_map<void*, ClientQueue>::const_iterator it = m_queues.begin();
+                 it != m_queues.end(); ++it)
+            {
+                if (it->first != excludeId)
+                {
+                    queued = queued || !it->second.queue.empty() || it->second.evicted;
+                    clients++;
+                }
+            }
+        }
+
+        if (clients == 0)
+        {
+            return;
+        }
+
+        if (!queued)
+        {
+            std::vector<char> d(data, data + size);
+            m_buffers++;
+
+            WebsocketServer::sendToAll(d, excludeId);
+
+            m_packetsSent += clients;
+            m_framesSent += clients;
+            return;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+
+        if (m_queues.empty())
+        {
+            return;
+        }
+
+        // serialized once, shared by all client queues
+        SharedPacket packet = std::make_shared<std::vector<char> >(data, data + size);
+        m_buffers++;
+
+        for (std::unordered_map<void*, ClientQueue>::iterator it = m_queues.begin();
+             it != m_queues.end(); ++it)
+        {
+            if (it->first != excludeId)
+            {
+                push(it->second, packet);
+            }
+        }
+    }
+
+    scheduleFlush();
+}
+
+bool WebsocketServerTransporter::sendDirect() const
+{
+    // nothing to limit, coalesce or batch: no hop to the pd thread
+    return m_maxQueue == 0 &&
+            m_maxRate <= 0 &&
+            !m_batch;
+}
+
+void WebsocketServerTransporter::push(ClientQueue& client, const SharedPacket& packet)
+{
+    if (client.evicted)
+    {
+        return;
     }
 
-    WebsocketServer::sendToAll(d, excludeId);
+    client.queue.push(packet);
+
+    size_t max_queue = m_maxQueue;
+    if (max_queue > 0 &&
+        client.queue.bytes() > max_queue)
+    {
+        // slow client: drop its queue, flush() sends it a full init later
+        // NOTE: scaryws can not close a single session
+        client.queue.clear();
+        client.evicted = true;
+        client.tokens = 0;
+
+        pd_queue_mess(&pd_maininstance, (t_pd*)m_x, (void*)(uintptr_t)client.id, pd_client_evicted);
+    }
+}
+
+void WebsocketServerTransporter::scheduleFlush()
+{
+    if (!m_flushScheduled.exchange(true))
+    {
+        pd_queue_mess(&pd_maininstance, (t_pd*)m_x, this, pd_websocket_server_flush);
+    }
+}
+
+void WebsocketServerTransporter::flush()
+{
+    m_flushScheduled = false;
+
+    float max_rate = m_maxRate;
+    bool batch = m_batch;
+    double elapsed = clock_gettimesince(m_lastFlush);
+    m_lastFlush = clock_getlogicaltime();
+
+    bool pending = false;
+
+    // a frame is a shared packet or - batched - packets copied into data
+    struct Frame
+    {
+        void* client;
+        SharedPacket packet;
+        std::vector<char> data;
+    };
+
+    // take the packets out of the queues, send without holding the queue lock
+    // NOTE: scaryws reports neither pending bytes nor completed writes,
+    //       so a queue is emptied whatever the client has read so far.
+    //       only the rate limit keeps packets here, where they can be coalesced.
+    std::vector<Frame> frames;
+    std::vector<void*> resyncs;
+    SharedPacket packet;
+    uint32_t packet_count = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+
+        for (std::unordered_map<void*, ClientQueue>::iterator it = m_queues.begin();
+             it != m_queues.end(); ++it)
+        {
+            ClientQueue& client = it->second;
+            size_t count = client.queue.count();
+
+            if (max_rate > 0)
+            {
+                // allow bursts of up to one second
+                double burst = std::max(1., (double)max_rate);
+                client.tokens = std::min(client.tokens + max_rate * elapsed / 1000., burst);
+
+                if (client.evicted &&
+                    client.tokens < burst)
+                {
+                    // one second without packets before the init
+                    pending = true;
+                    continue;
+                }
+            }
+
+            if (client.evicted)
+            {
+                client.evicted = false;
+                resyncs.push_back(it->first);
+                continue;
+            }
+
+            if (max_rate > 0)
+            {
+                if ((double)count > client.tokens)
+                {
+                    count = (size_t)client.tokens;
+                    pending = true;
+                }
+
+                client.tokens -= count;
+            }
+
+            for (size_t i=0; i<count; i++)
+            {
+                client.queue.pop(packet);
+                packet_count++;
+
+                if (batch &&
+                    !frames.empty() &&
+                    frames.back().client == it->first)
+                {
+                    Frame& frame = frames.back();
+                    size_t frame_size = frame.packet ? frame.packet->size() : frame.data.size();
+
+                    if (frame_size + packet->size() <= RCP_BATCH_FRAME_SIZE)
+                    {
+                        // append to the frame of this client
+                        if (frame.packet)
+                        {
+                            frame.data.reserve(RCP_BATCH_FRAME_SIZE);
+                            frame.data.assign(frame.packet->begin(), frame.packet->end());
+                            frame.packet.reset();
+                            m_buffers++;
+                        }
+
+                        frame.data.insert(frame.data.end(), packet->begin(), packet->end());
+                        continue;
+                    }
+                }
+
+                Frame frame;
+                frame.client = it->first;
+                frame.packet.swap(packet);
+                frames.push_back(std::move(frame));
+            }
+        }
+    }
+
+    for (size_t i=0; i<frames.size(); i++)
+    {
+        WebsocketServer::sendTo(frames[i].packet ? *frames[i].packet : frames[i].data,
+                                frames[i].client);
+    }
+
+    m_packetsSent += packet_count;
+    m_framesSent += frames.size();
+
+    for (size_t i=0; i<resyncs.size(); i++)
+    {
+        resync(resyncs[i]);
+    }
+
+    if (pending &&
+        m_rateClock)
+    {
+        clock_delay(m_rateClock, 1000. / max_rate);
+    }
+}
+
+void WebsocketServerTransporter::resync(void* client)
+{
+    if (m_transporter == nullptr ||
+        m_transporter->received == nullptr)
+    {
+        return;
+    }
+
+    // answer as if the client asked for an init: all parameters are queued for it again
+    const char init[2] = { COMMAND_INITIALIZE, RCP_TERMINATOR };
+
+    Threading::TimedLock lock(m_mutex, LOCK_SITE_RECEIVED);
+
+    rcp_server_transporter_call_recv_cb(m_transporter, init, sizeof(init), client);
 }
 
 // IServerTransporter
@@ -149,6 +452,66 @@ size_t WebsocketServerTransporter::clientCount() const
     return WebsocketServer::clientCount();
 }
 
+void WebsocketServerTransporter::setMaxQueue(size_t bytes)
+{
+    m_maxQueue = bytes;
+}
+
+void WebsocketServerTransporter::setMaxRate(float updatesPerSecond)
+{
+    m_maxRate = updatesPerSecond > 0 ? updatesPerSecond : 0;
+
+    // send what is queued with the new rate
+    scheduleFlush();
+}
+
+void WebsocketServerTransporter::setBatch(bool batch)
+{
+    m_batch = batch;
+}
+
+void WebsocketServerTransporter::sendStats(uint32_t& packets, uint32_t& frames, uint32_t& buffers) const
+{
+    packets = m_packetsSent;
+    frames = m_framesSent;
+    buffers = m_buffers;
+}
+
+void WebsocketServerTransporter::memoryUsage(size_t& queuedBytes, size_t& payloads) const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+
+    queuedBytes = 0;
+    payloads = 0;
+
+    for (std::unordered_map<void*, ClientQueue>::const_iterator it = m_queues.begin();
+         it != m_queues.end(); ++it)
+    {
+        // shared packets are counted per client
+        queuedBytes += it->second.queue.bytes();
+    }
+}
+
+void WebsocketServerTransporter::clientQueueStats(std::vector<ClientQueueStats>& stats) const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+
+    for (std::unordered_map<void*, ClientQueue>::const_iterator it = m_queues.begin();
+         it != m_queues.end(); ++it)
+    {
+        ClientQueueStats s;
+        s.id = it->second.id;
+        s.packets = it->second.queue.count();
+        s.bytes = it->second.queue.bytes();
+        s.coalesced = it->second.queue.coalesced();
+        s.evicted = it->second.evicted;
+        stats.push_back(s);
+    }
+
+    std::sort(stats.begin(), stats.end(),
+              [](const ClientQueueStats& a, const ClientQueueStats& b) { return a.id < b.id; });
+}
+
 
 // threaded
 void WebsocketServerTransporter::listening()
@@ -158,16 +521,34 @@ void WebsocketServerTransporter::listening()
 
 void WebsocketServerTransporter::closed()
 {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queues.clear();
+    }
+
     pd_queue_mess(&pd_maininstance, (t_pd*)m_x, NULL, pd_server_unbound);
 }
 
 void WebsocketServerTransporter::clientConnected(void* client)
 {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+
+        ClientQueue& queue = m_queues[client];
+        queue = ClientQueue();
+        queue.id = m_nextClientId++;
+    }
+
     pd_queue_mess(&pd_maininstance, (t_pd*)m_x, NULL, pd_client_connected);
 }
 
 void WebsocketServerTransporter::clientDisconnected(void* client)
 {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queues.erase(client);
+    }
+
     pd_queue_mess(&pd_maininstance, (t_pd*)m_x, NULL, pd_client_disconnected);
 }
 
@@ -181,7 +562,7 @@ void WebsocketServerTransporter::received(const char* data, size_t size, void* c
     {
         if (m_transporter->received)
         {
-            std::lock_guard<std::recursive_mutex> lock(Threading::mutex);
+            Threading::TimedLock lock(m_mutex, LOCK_SITE_RECEIVED);
 
             rcp_server_transporter_call_recv_cb(m_transporter, data, size, client);
         }
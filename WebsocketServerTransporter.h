@@ -38,6 +38,10 @@
 #ifndef WEBSOCKETSERVERTRANSPORTER_H
 #define WEBSOCKETSERVERTRANSPORTER_H
 
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
 #include <m_pd.h>
 
 #include <WebsocketServer.h>
@@ -45,6 +49,8 @@
 #include <rcp_server_transporter.h>
 
 #include "IServerTransporter.h"
+#include "OutboundQueue.h"
+#include "Threading.h"
 
 using namespace scaryws;
 
@@ -56,12 +62,15 @@ class WebsocketServerTransporter
     , public IServerTransporter
 {
 public:
-    WebsocketServerTransporter(t_pd* x);
+    WebsocketServerTransporter(t_pd* x, Threading::Mutex& mutex);
     ~WebsocketServerTransporter();
 
     void sendToOne(const char* data, size_t size, void* id);
     void sendToAll(const char* data, size_t size, void* excludeId);
 
+    // send queued packets - pd thread
+    void flush();
+
 public:
     // IServerTransporter
     rcp_server_transporter* transporter() const override;
@@ -70,6 +79,12 @@ public:
     uint16_t port() const override;
     bool isListening() const override;
     size_t clientCount() const override;
+    void setMaxQueue(size_t bytes) override;
+    void setMaxRate(float updatesPerSecond) override;
+    void clientQueueStats(std::vector<ClientQueueStats>& stats) const override;
+    void setBatch(bool batch) override;
+    void sendStats(uint32_t& packets, uint32_t& frames, uint32_t& buffers) const override;
+    void memoryUsage(size_t& queuedBytes, size_t& payloads) const override;
 
 public:
     // IServerSessionListener
@@ -82,7 +97,42 @@ public:
 
 private:
     t_pd* m_x{nullptr};
+    Threading::Mutex& m_mutex;
     rcp_server_transporter* m_transporter{nullptr};
+
+private:
+    struct ClientQueue
+    {
+        uint32_t id{0};
+        OutboundQueue queue;
+        double tokens{0};
+        // dropped queue - gets a full init once the rate allows
+        bool evicted{false};
+    };
+
+    bool sendDirect() const;
+    void push(ClientQueue& client, const SharedPacket& packet);
+    void resync(void* client);
+    void scheduleFlush();
+
+    // one queue per connected client
+    mutable std::mutex m_queueMutex;
+    std::unordered_map<void*, ClientQueue> m_queues;
+    uint32_t m_nextClientId{1};
+    std::atomic<bool> m_flushScheduled{false};
+
+    // limits
+    std::atomic<size_t> m_maxQueue{0};
+    std::atomic<float> m_maxRate{0};
+    std::atomic<bool> m_batch{false};
+    std::atomic<uint32_t> m_packetsSent{0};
+    std::atomic<uint32_t> m_framesSent{0};
+    // send buffers allocated
+    std::atomic<uint32_t> m_buffers{0};
+
+    // pd thread
+    t_clock* m_rateClock{nullptr};
+    double m_lastFlush{0};
 };
 
 } // namespace rcp
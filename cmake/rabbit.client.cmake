@@ -5,9 +5,15 @@ set(RCP_CLIENT_SOURCES
   PdRcp.h PdRcp.cpp
   WebsocketClientTransporter.h WebsocketClientTransporter.cpp
   ParameterServerClientBase.h ParameterServerClientBase.cpp
+  ParameterMessage.h
+  ParameterMessageQueue.h ParameterMessageQueue.cpp
+  ParameterIndex.h ParameterIndex.cpp
+  SpscRing.h
   ParameterClient.h ParameterClient.cpp
   PdMaxUtils.h
   Threading.h Threading.cpp
+  LockStats.h LockStats.cpp
+  OutboundQueue.h
   IClientTransporter.h
   PdClientTransporter.h PdClientTransporter.cpp
 )
@@ -6,9 +6,18 @@ set(RCP_SERVER_SOURCES
   RabbitHoleServerTransporter.h RabbitHoleServerTransporter.cpp
   WebsocketServerTransporter.h WebsocketServerTransporter.cpp
   ParameterServerClientBase.h ParameterServerClientBase.cpp
+  ParameterMessage.h
+  ParameterMessageQueue.h ParameterMessageQueue.cpp
+  ParameterIndex.h ParameterIndex.cpp
+  SpscRing.h
   ParameterServer.h ParameterServer.cpp
+  SchemaLoader.h SchemaLoader.cpp
+  ParameterState.h ParameterState.cpp
+  Preset.h
   PdMaxUtils.h
   Threading.h Threading.cpp
+  LockStats.h LockStats.cpp
+  OutboundQueue.h OutboundQueue.cpp
   IServerTransporter.h
   PdServerTransporter.h PdServerTransporter.cpp
 )
@@ -0,0 +1,31 @@
+# unit tests - plain executables, no pd needed
+enable_testing()
+
+add_executable(schemaloader_test tests/SchemaLoaderTest.cpp SchemaLoader.h SchemaLoader.cpp)
+target_include_directories(schemaloader_test PRIVATE ${CMAKE_CURRENT_SOURCE_DIR})
+
+add_test(NAME schemaloader COMMAND schemaloader_test)
+
+# rcp-c only for its constants
+add_executable(parameterstate_test tests/ParameterStateTest.cpp ParameterState.h ParameterState.cpp)
+target_include_directories(parameterstate_test PRIVATE ${CMAKE_CURRENT_SOURCE_DIR})
+target_link_libraries(parameterstate_test PRIVATE rcpc)
+
+add_test(NAME parameterstate COMMAND parameterstate_test)
+
+add_executable(outboundqueue_test tests/OutboundQueueTest.cpp OutboundQueue.h OutboundQueue.cpp)
+target_include_directories(outboundqueue_test PRIVATE ${CMAKE_CURRENT_SOURCE_DIR})
+target_link_libraries(outboundqueue_test PRIVATE rcpc)
+
+add_test(NAME outboundqueue COMMAND outboundqueue_test)
+
+add_executable(spscring_test tests/SpscRingTest.cpp SpscRing.h)
+target_include_directories(spscring_test PRIVATE ${CMAKE_CURRENT_SOURCE_DIR})
+
+add_test(NAME spscring COMMAND spscring_test)
+
+# pd headers only for t_atom
+add_executable(parametermessagequeue_test tests/ParameterMessageQueueTest.cpp ParameterMessage.h ParameterMessageQueue.h ParameterMessageQueue.cpp SpscRing.h)
+target_include_directories(parametermessagequeue_test PRIVATE ${CMAKE_CURRENT_SOURCE_DIR} ${CMAKE_CURRENT_SOURCE_DIR}/dependencies/pd)
+
+add_test(NAME parametermessagequeue COMMAND parametermessagequeue_test)
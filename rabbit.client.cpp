@@ -93,6 +93,54 @@ void rcpclient_disconnect(t_rabbit_client_pd *x)
     }
 }
 
+void rcpclient_defer(t_rabbit_client_pd *x, float defer)
+{
+    if (x->parameter_client)
+    {
+        x->parameter_client->setDefer(defer != 0);
+    }
+}
+
+void rcpclient_lockstats(t_rabbit_client_pd *x, float enabled)
+{
+    if (x->parameter_client)
+    {
+        x->parameter_client->setLockStats(enabled != 0);
+    }
+}
+
+void rcpclient_batch(t_rabbit_client_pd *x, float batch)
+{
+    if (x->parameter_client)
+    {
+        x->parameter_client->setBatch(batch != 0);
+    }
+}
+
+void rcpclient_getsendstats(t_rabbit_client_pd *x)
+{
+    if (x->parameter_client)
+    {
+        x->parameter_client->outputSendStats();
+    }
+}
+
+void rcpclient_setmany(t_rabbit_client_pd *x, t_symbol *s, int argc, t_atom *argv)
+{
+    if (x->parameter_client)
+    {
+        x->parameter_client->setMany(argc, argv);
+    }
+}
+
+void rcpclient_setmanypath(t_rabbit_client_pd *x, t_symbol *s, int argc, t_atom *argv)
+{
+    if (x->parameter_client)
+    {
+        x->parameter_client->setManyPath(argc, argv);
+    }
+}
+
 void post_rcp_version(t_rabbit_client_pd *x)
 {
     PdRcp::postRabbitcontrolInit();
@@ -135,6 +183,12 @@ void setup_rabbit0x2eclient(void) {
     class_addanything(rcp_client_pd_class, (t_method)rcpclient_any);
 
     class_addmethod(rcp_client_pd_class, (t_method)post_rcp_version, gensym("getrcpversion"), A_NULL);
+    class_addmethod(rcp_client_pd_class, (t_method)rcpclient_defer, gensym("defer"), A_FLOAT, A_NULL);
+    class_addmethod(rcp_client_pd_class, (t_method)rcpclient_lockstats, gensym("lockstats"), A_FLOAT, A_NULL);
+    class_addmethod(rcp_client_pd_class, (t_method)rcpclient_setmany, gensym("setmany"), A_GIMME, A_NULL);
+    class_addmethod(rcp_client_pd_class, (t_method)rcpclient_setmanypath, gensym("setmanypath"), A_GIMME, A_NULL);
+    class_addmethod(rcp_client_pd_class, (t_method)rcpclient_batch, gensym("batch"), A_FLOAT, A_NULL);
+    class_addmethod(rcp_client_pd_class, (t_method)rcpclient_getsendstats, gensym("getsendstats"), A_NULL);
 
     // NOTE: getter are handled with inlet anything
 
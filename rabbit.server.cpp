@@ -105,30 +105,20 @@ void pd_client_disconnected(t_pd *obj, void *data)
     }
 }
 
-void pd_raw_data_out(t_pd *obj, void *data)
+void pd_client_evicted(t_pd *obj, void *data)
 {
-    std::string* str = (std::string*)data;
-
     if (obj != NULL)
     {
         t_rabbit_server_pd* x = (t_rabbit_server_pd*)obj;
-        if (str)
-        {
-            x->parameter_server->dataOut(str->data(), str->length());
-        }
-    }
-    else
-    {
-        // data got cancled
-    }
 
-    if (str)
-    {
-        delete str;
+        // clientevicted <client id>
+        t_atom id;
+        SETFLOAT(&id, (t_float)(uintptr_t)data);
+
+        outlet_anything(x->info_out, gensym("clientevicted"), 1, &id);
     }
 }
 
-
 // pd interface
 
 void rcpserver_bang(t_rabbit_server_pd *x)
@@ -283,6 +273,155 @@ void rcpserver_parameter_set_minmax(t_rabbit_server_pd *x, t_symbol *s, int argc
     }
 }
 
+void rcpserver_defer(t_rabbit_server_pd *x, float defer)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->setDefer(defer != 0);
+    }
+}
+
+void rcpserver_lockstats(t_rabbit_server_pd *x, float enabled)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->setLockStats(enabled != 0);
+    }
+}
+
+void rcpserver_maxqueue(t_rabbit_server_pd *x, float bytes)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->setMaxQueue(bytes);
+    }
+}
+
+void rcpserver_maxrate(t_rabbit_server_pd *x, float rate)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->setMaxRate(rate);
+    }
+}
+
+void rcpserver_getclientstats(t_rabbit_server_pd *x)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->outputClientStats();
+    }
+}
+
+void rcpserver_getrawstats(t_rabbit_server_pd *x)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->outputRawStats();
+    }
+}
+
+void rcpserver_batch(t_rabbit_server_pd *x, float batch)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->setBatch(batch != 0);
+    }
+}
+
+void rcpserver_getsendstats(t_rabbit_server_pd *x)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->outputSendStats();
+    }
+}
+
+void rcpserver_setmany(t_rabbit_server_pd *x, t_symbol *s, int argc, t_atom *argv)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->setMany(argc, argv);
+    }
+}
+
+void rcpserver_setmanypath(t_rabbit_server_pd *x, t_symbol *s, int argc, t_atom *argv)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->setManyPath(argc, argv);
+    }
+}
+
+void rcpserver_loadschema(t_rabbit_server_pd *x, t_symbol* file)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->loadSchema(file->s_name);
+    }
+}
+
+void rcpserver_savestate(t_rabbit_server_pd *x, t_symbol* file)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->saveState(file->s_name);
+    }
+}
+
+void rcpserver_loadstate(t_rabbit_server_pd *x, t_symbol* file)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->loadState(file->s_name);
+    }
+}
+
+void rcpserver_preset(t_rabbit_server_pd *x, t_symbol *s, int argc, t_atom *argv)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->preset(argc, argv);
+    }
+}
+
+void rcpserver_begin(t_rabbit_server_pd *x)
+{
+    if (x->parameter_server)
+    {
+        x->parameter_server->begin();
+    }
+}
+
+void rcpserver_commit(t_rabbit_server_pd *x, t_symbol *s, int argc, t_atom *argv)
+{
+    if (x->parameter_server)
+    {
+        bool all = argc > 0 &&
+                argv[0].a_type == A_SYMBOL &&
+                argv[0].a_w.w_symbol == gensym("all");
+
+        if (argc > 0 && !all)
+        {
+            pd_error(x, "commit: expected no argument or 'all'");
+            return;
+        }
+
+        x->parameter_server->commit(all);
+    }
+}
+
+void rcpserver_gettransaction(t_rabbit_server_pd *x)
+{
+    if (x->parameter_server)
+    {
+        t_atom a;
+        setInt(a, x->parameter_server->transactionDepth());
+
+        outlet_anything(x->info_out, gensym("transaction"), 1, &a);
+    }
+}
+
 void post_rcp_version(t_rabbit_server_pd *x)
 {
     PdRcp::postRabbitcontrolInit();
@@ -327,6 +466,10 @@ void setup_rabbit0x2eserver(void) {
     class_addanything(rcp_server_pd_class, (t_method)rcpserver_any);
 
     class_addmethod(rcp_server_pd_class, (t_method)post_rcp_version, gensym("getrcpversion"), A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_defer, gensym("defer"), A_FLOAT, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_lockstats, gensym("lockstats"), A_FLOAT, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_setmany, gensym("setmany"), A_GIMME, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_setmanypath, gensym("setmanypath"), A_GIMME, A_NULL);
 
 
     // NOTE: getter are handled with inlet anything
@@ -334,8 +477,21 @@ void setup_rabbit0x2eserver(void) {
     // parameter server
     class_addmethod(rcp_server_pd_class, (t_method)rcpserver_listen, gensym("listen"), A_GIMME, A_NULL);
     class_addmethod(rcp_server_pd_class, (t_method)rcpserver_getport, gensym("getport"), A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_maxqueue, gensym("maxqueue"), A_FLOAT, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_maxrate, gensym("maxrate"), A_FLOAT, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_getclientstats, gensym("getclientstats"), A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_batch, gensym("batch"), A_FLOAT, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_getsendstats, gensym("getsendstats"), A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_getrawstats, gensym("getrawstats"), A_NULL);
 
     class_addmethod(rcp_server_pd_class, (t_method)rcpserver_expose_parameter, gensym("expose"), A_GIMME, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_loadschema, gensym("loadschema"), A_SYMBOL, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_savestate, gensym("savestate"), A_SYMBOL, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_loadstate, gensym("loadstate"), A_SYMBOL, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_preset, gensym("preset"), A_GIMME, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_begin, gensym("begin"), A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_commit, gensym("commit"), A_GIMME, A_NULL);
+    class_addmethod(rcp_server_pd_class, (t_method)rcpserver_gettransaction, gensym("gettransaction"), A_NULL);
     class_addmethod(rcp_server_pd_class, (t_method)rcpserver_remove_parameter, gensym("remove"), A_FLOAT, A_NULL);
     class_addmethod(rcp_server_pd_class, (t_method)rcpserver_remove_parameter_sym, gensym("remove"), A_GIMME, A_NULL);
 
@@ -74,7 +74,7 @@ void pd_server_bound(t_pd *obj, void *data);
 void pd_server_unbound(t_pd *obj, void *data);
 void pd_client_connected(t_pd *obj, void *data);
 void pd_client_disconnected(t_pd *obj, void *data);
-void pd_raw_data_out(t_pd *obj, void *data);
+void pd_client_evicted(t_pd *obj, void *data);
 
 #ifdef __cplusplus
 } // extern "C"
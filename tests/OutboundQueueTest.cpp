@@ -0,0 +1,251 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+// outbound queue cases: value packet detection byte by byte, coalescing
+// and ordering
+// returns the number of failed checks
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <rcp.h>
+
+#include "OutboundQueue.h"
+
+using rcp::OutboundQueue;
+using rcp::SharedPacket;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+typedef std::vector<unsigned char> Bytes;
+
+static bool key(const Bytes& data, uint16_t& out)
+{
+    out = 0;
+    return OutboundQueue::valueKey((const char*)data.data(), data.size(), out);
+}
+
+// update: command, data option, id, type, terminator, value option, value, 2 terminators
+static Bytes update(uint16_t id, unsigned char type, const Bytes& value)
+{
+    Bytes data;
+    data.push_back(COMMAND_UPDATE);
+    data.push_back(PACKET_OPTIONS_DATA);
+    data.push_back((unsigned char)(id >> 8));
+    data.push_back((unsigned char)(id & 0xFF));
+    data.push_back(type);
+    data.push_back(RCP_TERMINATOR);
+    data.push_back(PARAMETER_OPTIONS_VALUE);
+    data.insert(data.end(), value.begin(), value.end());
+    data.push_back(RCP_TERMINATOR);
+    data.push_back(RCP_TERMINATOR);
+    return data;
+}
+
+static Bytes updateValue(uint16_t id, unsigned char type, const Bytes& value)
+{
+    Bytes data;
+    data.push_back(COMMAND_UPDATEVALUE);
+    data.push_back((unsigned char)(id >> 8));
+    data.push_back((unsigned char)(id & 0xFF));
+    data.push_back(type);
+    data.insert(data.end(), value.begin(), value.end());
+    return data;
+}
+
+static Bytes longString(const char* s, size_t size)
+{
+    Bytes data;
+    data.push_back((unsigned char)(size >> 24));
+    data.push_back((unsigned char)(size >> 16));
+    data.push_back((unsigned char)(size >> 8));
+    data.push_back((unsigned char)size);
+    data.insert(data.end(), s, s + size);
+    return data;
+}
+
+static SharedPacket packet(const Bytes& data)
+{
+    return std::make_shared<std::vector<char> >(data.begin(), data.end());
+}
+
+static void testUpdateValue()
+{
+    uint16_t k = 0;
+
+    check(key(updateValue(0x1234, DATATYPE_FLOAT32, Bytes(4, 0)), k) && k == 0x1234, "updatevalue key, big endian id");
+    check(key(updateValue(1, DATATYPE_BOOLEAN, Bytes(1, 1)), k) && k == 1, "updatevalue boolean");
+
+    Bytes short_packet(3);
+    short_packet[0] = COMMAND_UPDATEVALUE;
+    check(!key(short_packet, k), "updatevalue shorter than 4 bytes");
+
+    check(!key(Bytes(), k), "empty packet");
+}
+
+static void testUpdate()
+{
+    uint16_t k = 0;
+
+    check(key(update(0xABCD, DATATYPE_INT32, Bytes(4, 7)), k) && k == 0xABCD, "update int key");
+    check(key(update(2, DATATYPE_FLOAT32, Bytes(4, 0)), k) && k == 2, "update float");
+    check(key(update(3, DATATYPE_BOOLEAN, Bytes(1, 1)), k) && k == 3, "update boolean");
+    check(key(update(4, DATATYPE_STRING, longString("abc", 3)), k) && k == 4, "update string");
+    check(key(update(5, DATATYPE_STRING, longString("", 0)), k) && k == 5, "update empty string");
+
+    // a string value holding terminators is still one value
+    check(key(update(6, DATATYPE_STRING, longString("\0\0\0", 3)), k) && k == 6, "update string with zero bytes");
+
+    // types without a fixed value layout
+    check(!key(update(7, DATATYPE_BANG, Bytes()), k), "update bang");
+    check(!key(update(7, DATATYPE_GROUP, Bytes()), k), "update group");
+}
+
+static void testNotValueOnly()
+{
+    uint16_t k = 0;
+    Bytes good = update(1, DATATYPE_INT32, Bytes(4, 0));
+
+    Bytes b = good;
+    b[0] = COMMAND_INITIALIZE;
+    check(!key(b, k), "other command");
+
+    b = good;
+    b[1] = 0x13;
+    check(!key(b, k), "other packet option");
+
+    b = good;
+    b[5] = 1;
+    check(!key(b, k), "no terminator after type");
+
+    b = good;
+    b[6] = 0x21;
+    check(!key(b, k), "other parameter option");
+
+    // more options after the value
+    b = good;
+    b.insert(b.end() - 2, 0x22);
+    b.insert(b.end() - 2, 0);
+    check(!key(b, k), "option after value");
+
+    b = good;
+    b[b.size() - 2] = 0x21;
+    check(!key(b, k), "option instead of terminator");
+
+    b = good;
+    b.push_back(0);
+    check(!key(b, k), "trailing byte");
+
+    // truncated at every length
+    for (size_t size=0; size<good.size(); size++)
+    {
+        Bytes t(good.begin(), good.begin() + size);
+        check(!key(t, k), "truncated update");
+    }
+
+    // string size past the end of the packet
+    Bytes s = update(1, DATATYPE_STRING, longString("abc", 3));
+    s[10] = 0xFF;
+    check(!key(s, k), "string size past end");
+
+    // string size short of the terminators
+    s = update(1, DATATYPE_STRING, longString("abc", 3));
+    s[10] = 2;
+    check(!key(s, k), "string size short");
+}
+
+static void testQueue()
+{
+    OutboundQueue queue;
+    SharedPacket out;
+
+    queue.push(packet(updateValue(1, DATATYPE_INT32, Bytes(4, 1))));
+    queue.push(packet(updateValue(2, DATATYPE_INT32, Bytes(4, 2))));
+    queue.push(packet(update(1, DATATYPE_INT32, Bytes(4, 3))));
+
+    check(queue.count() == 2, "value of 1 replaced");
+    check(queue.coalesced() == 1, "coalesced count");
+    check(queue.bytes() == update(1, DATATYPE_INT32, Bytes(4, 3)).size() + 8, "bytes after replace");
+
+    // the replacement keeps the position of the first value
+    check(queue.pop(out) && (*out)[0] == COMMAND_UPDATE, "replaced value first");
+    check(queue.pop(out) && (*out)[3] == DATATYPE_INT32 && (*out)[4] == 2, "other value second");
+    check(!queue.pop(out) && queue.empty() && queue.bytes() == 0, "queue empty");
+
+    // no value moves before a structural packet
+    queue.push(packet(updateValue(1, DATATYPE_INT32, Bytes(4, 1))));
+    Bytes structural = update(1, DATATYPE_INT32, Bytes(4, 2));
+    structural.insert(structural.end() - 2, 0x22);
+    structural.insert(structural.end() - 2, 0);
+    queue.push(packet(structural));
+    queue.push(packet(updateValue(1, DATATYPE_INT32, Bytes(4, 3))));
+    check(queue.count() == 3, "value after structural packet queued");
+
+    // a popped value is not replaced
+    queue.clear();
+    queue.push(packet(updateValue(1, DATATYPE_INT32, Bytes(4, 1))));
+    queue.push(packet(updateValue(2, DATATYPE_INT32, Bytes(4, 1))));
+    queue.pop(out);
+    queue.push(packet(updateValue(1, DATATYPE_INT32, Bytes(4, 2))));
+    check(queue.count() == 2, "popped value not replaced");
+}
+
+int main()
+{
+    testUpdateValue();
+    testUpdate();
+    testNotValueOnly();
+    testQueue();
+
+    if (failures == 0)
+    {
+        printf("all passed\n");
+    }
+
+    return failures;
+}
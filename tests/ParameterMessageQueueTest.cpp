@@ -0,0 +1,278 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+// parameter message queue cases: order between the ring and overflow messages,
+// one drain per batch, recycling of overflow messages
+// the pd thread is simulated: scheduled work runs in order, like pd_queue_mess
+// returns the number of failed checks
+
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include "ParameterMessageQueue.h"
+
+using rcp::IParameterMessageOutput;
+using rcp::OverflowMessage;
+using rcp::ParameterMessage;
+using rcp::ParameterMessageQueue;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static t_symbol selector;
+
+class Output : public IParameterMessageOutput
+{
+public:
+    void scheduleDrain() override
+    {
+        drains++;
+        work.push_back(nullptr);
+    }
+
+    void scheduleOverflow(OverflowMessage* message) override
+    {
+        work.push_back(message);
+    }
+
+    void outputMessage(ParameterMessage& message) override
+    {
+        ids.push_back(message.id);
+    }
+
+    // run scheduled work, at most count items
+    void run(ParameterMessageQueue& queue, size_t count = (size_t)-1)
+    {
+        while (!work.empty() && count > 0)
+        {
+            OverflowMessage* message = work.front();
+            work.pop_front();
+
+            if (message == nullptr)
+            {
+                queue.drain();
+            }
+            else
+            {
+                queue.outputOverflow(message);
+            }
+
+            count--;
+        }
+    }
+
+    bool inOrder(int16_t count) const
+    {
+        if (ids.size() != (size_t)count)
+        {
+            return false;
+        }
+
+        for (int16_t i=0; i<count; i++)
+        {
+            if (ids[i] != i)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // nullptr: drain
+    std::deque<OverflowMessage*> work;
+    std::vector<int16_t> ids;
+    int drains{0};
+};
+
+static void push(ParameterMessageQueue& queue, int16_t id, int size = 1)
+{
+    ParameterMessage message(id, &selector, size);
+    message.argc = size;
+    queue.push(message);
+}
+
+static void testBatch()
+{
+    Output output;
+    ParameterMessageQueue queue(output, 8, 4);
+
+    for (int16_t i=0; i<5; i++)
+    {
+        push(queue, i);
+    }
+
+    check(output.drains == 1, "one drain per batch");
+    check(queue.size() == 5 && queue.queued() == 5, "batch in the ring");
+
+    output.run(queue);
+    check(output.inOrder(5), "batch in order");
+    check(queue.size() == 0, "ring drained");
+
+    push(queue, 5);
+    check(output.drains == 2, "new batch after a drain");
+
+    output.run(queue);
+    check(output.inOrder(6), "second batch in order");
+}
+
+static void testRingFull()
+{
+    Output output;
+    ParameterMessageQueue queue(output, 4, 4);
+
+    // 4 in the ring, then the ring is full: the rest goes on its own
+    for (int16_t i=0; i<10; i++)
+    {
+        push(queue, i);
+    }
+
+    check(queue.queued() == 4, "ring took its capacity");
+    check(queue.overflowed() == 6 && queue.overflowPending() == 6, "rest overflowed");
+
+    // the drain was scheduled before the first overflow message
+    output.run(queue);
+    check(output.inOrder(10), "ring before overflow");
+    check(queue.overflowPending() == 0, "no overflow pending");
+}
+
+static void testOverflowKeepsOrder()
+{
+    Output output;
+    ParameterMessageQueue queue(output, 4, 4);
+
+    for (int16_t i=0; i<5; i++)
+    {
+        push(queue, i);
+    }
+
+    // the ring is empty again, an overflow message is still pending
+    output.run(queue, 1);
+    check(queue.size() == 0 && queue.overflowPending() == 1, "ring drained, overflow pending");
+
+    // must not overtake the pending message through the ring
+    push(queue, 5);
+    check(queue.overflowPending() == 2, "later message overflows too");
+
+    output.run(queue);
+    check(output.inOrder(6), "overflow order kept");
+
+    // back to the ring
+    push(queue, 6);
+    check(queue.size() == 1, "ring used again");
+
+    output.run(queue);
+    check(output.inOrder(7), "ring after overflow in order");
+}
+
+static void testLongMessage()
+{
+    Output output;
+    ParameterMessageQueue queue(output, 8, 4);
+
+    push(queue, 0);
+    push(queue, 1, RCP_PARAMETER_MESSAGE_ATOMS + 1);
+    push(queue, 2);
+
+    check(queue.queued() == 1, "long message not in the ring");
+    check(queue.overflowed() == 2, "long message and the next overflowed");
+
+    output.run(queue);
+    check(output.inOrder(3), "long message in order");
+}
+
+static void testPool()
+{
+    Output output;
+    ParameterMessageQueue queue(output, 1, 2);
+
+    // fill the ring, then 3 overflow messages: all allocated
+    push(queue, 0);
+    push(queue, 1);
+    push(queue, 2);
+    push(queue, 3);
+    check(queue.allocated() == 3, "overflow messages allocated");
+
+    output.run(queue);
+    check(output.inOrder(4), "pool order");
+
+    // only pool size messages are kept
+    check(queue.pooled() == 2, "pool keeps its size");
+
+    // reused: no allocation for two overflow messages
+    push(queue, 4);
+    push(queue, 5);
+    push(queue, 6);
+    check(queue.allocated() == 3, "pooled messages reused");
+    check(queue.pooled() == 0, "pool emptied");
+
+    // a recycled message holds the new values
+    output.run(queue);
+    check(output.inOrder(7), "recycled messages in order");
+
+    // a recycled long message
+    push(queue, 7);
+    push(queue, 8, RCP_PARAMETER_MESSAGE_ATOMS + 4);
+    check(queue.allocated() == 4, "long atoms counted, message reused");
+    output.run(queue);
+    check(output.inOrder(9), "recycled long message in order");
+}
+
+int main()
+{
+    testBatch();
+    testRingFull();
+    testOverflowKeepsOrder();
+    testLongMessage();
+    testPool();
+
+    if (failures == 0)
+    {
+        printf("all passed\n");
+    }
+
+    return failures;
+}
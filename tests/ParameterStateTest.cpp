@@ -0,0 +1,256 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+// state image cases: roundtrip of every type and option, truncated and
+// corrupt input
+// returns the number of failed checks
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <rcp.h>
+
+#include "ParameterState.h"
+
+using rcp::ParameterState;
+using rcp::StateRecord;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static StateRecord record(uint8_t type, int32_t parent, const std::string& label)
+{
+    StateRecord r;
+    r.type = type;
+    r.parent = parent;
+    r.label = label;
+    return r;
+}
+
+// a group with one parameter of each type
+static void fill(ParameterState& state)
+{
+    std::vector<StateRecord>& records = state.records();
+
+    StateRecord group = record(DATATYPE_GROUP, -1, "group");
+    group.flags = StateRecord::ORDER;
+    group.order = -3;
+    records.push_back(group);
+
+    StateRecord f = record(DATATYPE_FLOAT32, 0, "float");
+    f.flags = StateRecord::MIN | StateRecord::MAX | StateRecord::VALUE;
+    f.min.f = -1.5f;
+    f.max.f = 2.5f;
+    f.number.f = 0.25f;
+    records.push_back(f);
+
+    StateRecord i = record(DATATYPE_INT32, 0, "int");
+    i.flags = StateRecord::READONLY | StateRecord::MIN | StateRecord::MAX | StateRecord::VALUE;
+    i.min.i = INT32_MIN;
+    i.max.i = INT32_MAX;
+    i.number.i = -42;
+    records.push_back(i);
+
+    StateRecord b = record(DATATYPE_BOOLEAN, -1, "toggle");
+    b.flags = StateRecord::VALUE;
+    b.boolean = true;
+    records.push_back(b);
+
+    StateRecord s = record(DATATYPE_STRING, -1, "");
+    s.flags = StateRecord::VALUE;
+    s.string = std::string("a\0b", 3);
+    records.push_back(s);
+
+    records.push_back(record(DATATYPE_BANG, 0, "bang"));
+}
+
+static std::vector<char> image()
+{
+    ParameterState state;
+    fill(state);
+
+    std::vector<char> data;
+    state.encode(data);
+    return data;
+}
+
+static void testRoundtrip()
+{
+    ParameterState original;
+    fill(original);
+
+    std::vector<char> data;
+    original.encode(data);
+
+    ParameterState state;
+    check(state.decode(data.data(), data.size()), "roundtrip decodes");
+    check(state.error().empty(), "roundtrip no error");
+
+    const std::vector<StateRecord>& a = original.records();
+    const std::vector<StateRecord>& b = state.records();
+    check(a.size() == b.size(), "roundtrip record count");
+
+    for (size_t i=0; i<a.size() && i<b.size(); i++)
+    {
+        check(a[i].type == b[i].type, "roundtrip type");
+        check(a[i].flags == b[i].flags, "roundtrip flags");
+        check(a[i].parent == b[i].parent, "roundtrip parent");
+        check(a[i].label == b[i].label, "roundtrip label");
+        check(a[i].order == b[i].order, "roundtrip order");
+        check(a[i].min.i == b[i].min.i, "roundtrip min");
+        check(a[i].max.i == b[i].max.i, "roundtrip max");
+        check(a[i].number.i == b[i].number.i, "roundtrip number");
+        check(a[i].boolean == b[i].boolean, "roundtrip boolean");
+        check(a[i].string == b[i].string, "roundtrip string");
+    }
+
+    // an encoded decode is the same image
+    std::vector<char> again;
+    state.encode(again);
+    check(again == data, "roundtrip image is stable");
+
+    // empty state
+    ParameterState empty;
+    std::vector<char> empty_data;
+    empty.encode(empty_data);
+    check(empty.decode(empty_data.data(), empty_data.size()) && empty.records().empty(), "empty roundtrip");
+}
+
+static void testTruncated()
+{
+    std::vector<char> data = image();
+
+    // every cut of the image
+    for (size_t size=0; size<data.size(); size++)
+    {
+        ParameterState state;
+        state.records().push_back(record(DATATYPE_BANG, -1, "stale"));
+
+        if (state.decode(data.data(), size))
+        {
+            printf("FAIL: truncated to %zu bytes decodes\n", size);
+            failures++;
+        }
+        else
+        {
+            check(!state.error().empty(), "truncated sets an error");
+            check(state.records().empty(), "truncated leaves no records");
+        }
+    }
+}
+
+// first record starts after the 12 byte header
+static const size_t RECORD = 12;
+
+static bool decodeChanged(size_t offset, char value)
+{
+    std::vector<char> data = image();
+    data[offset] = value;
+
+    ParameterState state;
+    return state.decode(data.data(), data.size());
+}
+
+static void testCorrupt()
+{
+    check(!decodeChanged(0, 'X'), "bad magic");
+    check(!decodeChanged(4, 2), "bad version");
+
+    // record count larger than the data
+    check(!decodeChanged(11, 0x7F), "bad record count");
+
+    // type byte
+    check(!decodeChanged(RECORD, 0), "invalid type");
+    check(!decodeChanged(RECORD, 99), "unknown type");
+
+    // flags byte
+    check(!decodeChanged(RECORD + 1, (char)0x80), "unknown flag");
+
+    // parent below root
+    check(!decodeChanged(RECORD + 2, (char)0xFE), "parent below root");
+
+    // label length past the end
+    check(!decodeChanged(RECORD + 7, 0x7F), "label past end");
+
+    // parents that are written later, the record itself or not a group
+    int32_t parents[3][2] = { { 0, 1 }, { 1, 1 }, { 2, 1 } };
+    const char* names[3] = { "parent after child", "parent is itself", "parameter as parent" };
+
+    for (int i=0; i<3; i++)
+    {
+        ParameterState state;
+        fill(state);
+        state.records()[parents[i][0]].parent = parents[i][1];
+
+        std::vector<char> data;
+        state.encode(data);
+        check(!state.decode(data.data(), data.size()), names[i]);
+    }
+
+    ParameterState state;
+
+    // garbage
+    std::string garbage(64, '\xFF');
+    check(!state.decode(garbage.data(), garbage.size()), "garbage");
+
+    // missing file
+    check(!state.read("/nonexistent/state.rcps"), "missing file");
+}
+
+int main()
+{
+    testRoundtrip();
+    testTruncated();
+    testCorrupt();
+
+    if (failures == 0)
+    {
+        printf("all passed\n");
+    }
+
+    return failures;
+}
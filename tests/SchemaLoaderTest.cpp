@@ -0,0 +1,258 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+// schema parser cases: malformed input, nesting depth, escapes and surrogates,
+// type names and number ranges
+// returns the number of failed checks
+
+#include <cfloat>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "SchemaLoader.h"
+
+using rcp::SchemaLoader;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static bool parse(SchemaLoader& loader, const std::string& json)
+{
+    return loader.parse(json.data(), json.size());
+}
+
+static bool parseLabel(const std::string& label, std::string& out)
+{
+    SchemaLoader loader;
+    if (!parse(loader, "[{\"label\": \"" + label + "\", \"type\": \"f\"}]"))
+    {
+        return false;
+    }
+
+    out = loader.nodes()[0].label;
+    return true;
+}
+
+static std::string nested(int depth)
+{
+    return std::string(depth, '[') + std::string(depth, ']');
+}
+
+static void testValid()
+{
+    SchemaLoader loader;
+    bool ok = parse(loader,
+                    "{ \"parameters\": ["
+                    "  { \"label\": \"fx\", \"children\": ["
+                    "    { \"label\": \"mix\", \"type\": \"f\", \"min\": 0, \"max\": 1, \"value\": 0.5 },"
+                    "    { \"label\": \"bypass\", \"type\": \"t\", \"readonly\": true }"
+                    "  ]}"
+                    "]}");
+
+    check(ok, "valid schema");
+    check(loader.count() == 3, "valid schema: count");
+    check(loader.nodes().size() == 1 &&
+          loader.nodes()[0].isGroup() &&
+          loader.nodes()[0].children.size() == 2, "valid schema: tree");
+}
+
+static void testMalformed()
+{
+    const char* cases[] = {
+        "",
+        "[",
+        "[{\"label\": \"a\", \"type\": \"f\"}",
+        "[{\"label\": \"a\" \"type\": \"f\"}]",
+        "[{\"label\": \"a\", \"type\": \"f\",}]",
+        "[{\"label\": \"a, \"type\": \"f\"}]",
+        "[{\"label\": \"a\", \"type\": \"f\", \"value\": 1.2.3}]",
+        "[{\"label\": \"a\", \"type\": \"f\", \"readonly\": tru}]",
+        "[] []",
+        "{\"params\": []}",
+        "[1]",
+        "[{\"type\": \"f\"}]",
+        "[{\"label\": \"a\"}]",
+        "[{\"label\": \"a\", \"children\": {}}]",
+    };
+
+    for (size_t i=0; i<sizeof(cases)/sizeof(cases[0]); i++)
+    {
+        SchemaLoader loader;
+        bool ok = parse(loader, cases[i]);
+
+        if (ok || loader.error().empty())
+        {
+            printf("  input: %s\n", cases[i]);
+        }
+
+        check(!ok, "malformed input rejected");
+        check(!loader.error().empty(), "malformed input: error set");
+        check(loader.nodes().empty() && loader.count() == 0, "malformed input: no nodes");
+    }
+}
+
+static void testDepth()
+{
+    SchemaLoader loader;
+
+    // within the limit: parsed, then rejected as not a parameter entry
+    check(!parse(loader, nested(100)), "nested arrays are no parameters");
+    check(loader.error().find("nesting too deep") == std::string::npos, "depth 100 parses");
+
+    check(!parse(loader, nested(1000)), "depth 1000 rejected");
+    check(loader.error().find("nesting too deep") != std::string::npos, "depth 1000: error");
+
+    // unbalanced - must fail on depth before running out of input
+    check(!parse(loader, std::string(100000, '[')), "deep unbalanced input rejected");
+    check(loader.error().find("nesting too deep") != std::string::npos, "deep unbalanced input: error");
+}
+
+static void testEscapes()
+{
+    std::string label;
+
+    check(parseLabel("a\\\"b\\\\c\\/d\\te", label) &&
+          label == "a\"b\\c/d\te", "simple escapes");
+
+    check(parseLabel("\\u0041\\u00e9\\u20ac", label) &&
+          label == "A\xC3\xA9\xE2\x82\xAC", "unicode escapes");
+
+    check(parseLabel("\\ud83d\\ude00", label) &&
+          label == "\xF0\x9F\x98\x80", "surrogate pair");
+
+    check(!parseLabel("\\x41", label), "invalid escape");
+    check(!parseLabel("\\u00g1", label), "invalid hex digit");
+    check(!parseLabel("\\u00", label), "short unicode escape");
+    check(!parseLabel("\\ud83d", label), "lone high surrogate");
+    check(!parseLabel("\\ud83dx", label), "high surrogate followed by text");
+    check(!parseLabel("\\ud83d\\u0041", label), "high surrogate followed by non-surrogate");
+    check(!parseLabel("\\ud83d\\ud83d", label), "two high surrogates");
+    check(!parseLabel("\\ude00", label), "lone low surrogate");
+}
+
+static void testChildren()
+{
+    SchemaLoader loader;
+
+    check(!parse(loader, "[{\"label\": \"a\", \"type\": \"f\", \"children\": []}]"),
+          "value type with children rejected");
+    check(loader.error().find("has children") != std::string::npos,
+          "value type with children: error");
+
+    check(parse(loader, "[{\"label\": \"a\", \"type\": \"group\", \"children\": []}]"),
+          "explicit group with children");
+}
+
+static void testTypes()
+{
+    const char* valid[][2] = {
+        { "f", "f" }, { "float", "f" },
+        { "i", "i" }, { "int", "i" },
+        { "t", "t" }, { "toggle", "t" }, { "bool", "t" },
+        { "b", "b" }, { "bang", "b" },
+        { "s", "s" }, { "string", "s" },
+    };
+
+    for (size_t i=0; i<sizeof(valid)/sizeof(valid[0]); i++)
+    {
+        SchemaLoader loader;
+        bool ok = parse(loader, std::string("[{\"label\": \"a\", \"type\": \"") + valid[i][0] + "\"}]");
+
+        check(ok && loader.nodes()[0].type == valid[i][1], valid[i][0]);
+    }
+
+    const char* invalid[] = { "boolean", "float64", "foo", "symbol", "F", "", "group " };
+
+    for (size_t i=0; i<sizeof(invalid)/sizeof(invalid[0]); i++)
+    {
+        SchemaLoader loader;
+        bool ok = parse(loader, std::string("[\n{\"label\": \"a\",\n \"type\": \"") + invalid[i] + "\"}]");
+
+        if (ok)
+        {
+            printf("  type: '%s'\n", invalid[i]);
+        }
+
+        check(!ok, "unknown type rejected");
+        check(loader.error().find("(line 3)") != std::string::npos, "unknown type: line number");
+    }
+
+    SchemaLoader loader;
+    check(!parse(loader, "[{\"label\": \"a\", \"type\": 1}]"), "numeric type rejected");
+}
+
+static void testRange()
+{
+    SchemaLoader loader;
+    bool ok = parse(loader, "[{\"label\": \"a\", \"type\": \"i\", \"min\": -1e300, \"max\": 1e999, \"order\": 1e20}]");
+
+    check(ok, "huge numbers parse");
+    if (ok)
+    {
+        const rcp::SchemaNode& node = loader.nodes()[0];
+        check(node.min.get() == -FLT_MAX, "min clamped");
+        check(node.max.get() == FLT_MAX, "max clamped");
+        check(node.order.get() == INT32_MAX, "order clamped");
+    }
+}
+
+int main()
+{
+    testValid();
+    testMalformed();
+    testDepth();
+    testEscapes();
+    testChildren();
+    testTypes();
+    testRange();
+
+    if (failures == 0)
+    {
+        printf("all passed\n");
+    }
+
+    return failures;
+}
@@ -0,0 +1,205 @@
+/*
+********************************************************************
+* rabbitcontrol - a protocol and data-format for remote control.
+*
+* https://rabbitcontrol.cc
+* https://github.com/rabbitControl/pure-rabbit
+*
+* This file is part of rabbitcontrol for Pd and Max.
+*
+* Written by Ingo Randolf, 2025
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, version 3.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*********************************************************************
+*/
+
+// ring cases: wraparound of the indices, full and empty, two-span push
+// returns the number of failed checks
+
+#include <cstdio>
+#include <vector>
+
+#include "SpscRing.h"
+
+using rcp::SpscRing;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static void testCapacity()
+{
+    SpscRing<int> a(5);
+    check(a.capacity() == 8, "capacity rounded up to a power of two");
+
+    SpscRing<int> b(8);
+    check(b.capacity() == 8, "power of two capacity kept");
+
+    SpscRing<int> c(1);
+    check(c.capacity() == 1, "capacity of one");
+    check(c.push(1) && !c.push(2), "capacity of one is full after one");
+}
+
+static void testFullEmpty()
+{
+    SpscRing<int> ring(4);
+
+    check(ring.front() == nullptr, "empty ring has no front");
+    check(ring.size() == 0, "empty ring size");
+
+    for (int i=0; i<4; i++)
+    {
+        check(ring.push(i), "push until full");
+    }
+
+    check(!ring.push(4), "push on a full ring fails");
+    check(ring.size() == 4, "full ring size");
+
+    // a failed push leaves the ring as it was
+    check(ring.front() != nullptr && *ring.front() == 0, "full ring front");
+}
+
+static void testWraparound()
+{
+    SpscRing<int> ring(4);
+    int next_push = 0;
+    int next_pop = 0;
+
+    // many times around the buffer, with changing fill levels
+    for (int round=0; round<1000; round++)
+    {
+        int pushes = 1 + round % 4;
+        for (int i=0; i<pushes; i++)
+        {
+            if (ring.push(next_push))
+            {
+                next_push++;
+            }
+        }
+
+        int pops = 1 + (round * 7) % 4;
+        for (int i=0; i<pops; i++)
+        {
+            int* v = ring.front();
+            if (v == nullptr)
+            {
+                break;
+            }
+
+            if (*v != next_pop)
+            {
+                printf("FAIL: wraparound order, got %d expected %d\n", *v, next_pop);
+                failures++;
+                return;
+            }
+
+            ring.pop();
+            next_pop++;
+        }
+
+        check(ring.size() == (size_t)(next_push - next_pop), "wraparound size");
+    }
+
+    check(next_push > 1000, "wraparound went around");
+}
+
+static void testIndexOverflow()
+{
+    // indices are free running: pop(count) and front()/pop() mixed
+    SpscRing<int> ring(4);
+    int out[4];
+
+    for (int i=0; i<10000; i++)
+    {
+        check(ring.push(i) && ring.push(i + 1) && ring.push(i + 2), "push three");
+        ring.pop(out, 2);
+        check(out[0] == i && out[1] == i + 1, "pop two in order");
+        check(ring.front() != nullptr && *ring.front() == i + 2, "third is front");
+        ring.pop();
+        check(ring.size() == 0, "empty again");
+    }
+}
+
+static void testTwoSpans()
+{
+    SpscRing<char> ring(8);
+    const char a[] = { 'a', 'b', 'c' };
+    const char b[] = { 'd', 'e' };
+
+    check(ring.push(a, 3, b, 2), "two spans fit");
+    check(ring.size() == 5, "two spans size");
+
+    char out[8];
+    ring.pop(out, 5);
+    check(out[0] == 'a' && out[2] == 'c' && out[3] == 'd' && out[4] == 'e', "two spans in order");
+
+    // tail is at 5: this push wraps around the end of the buffer
+    const char c[] = { '1', '2', '3', '4', '5' };
+    const char d[] = { '6', '7' };
+    check(ring.push(c, 5, d, 2), "wrapping two spans fit");
+
+    ring.pop(out, 7);
+    check(std::vector<char>(out, out + 7) == std::vector<char>({ '1', '2', '3', '4', '5', '6', '7' }),
+          "wrapping two spans in order");
+
+    // all or nothing
+    check(ring.push(a, 3, b, 2), "refill");
+    check(!ring.push(a, 3, b, 1), "no room for both spans");
+    check(ring.size() == 5, "failed push wrote nothing");
+    check(ring.push(a, 3, b, 0), "second span empty");
+    check(!ring.push(a, 0, b, 1), "full");
+
+    ring.pop(out, 8);
+    check(out[5] == 'a' && out[7] == 'c', "second span empty in order");
+
+    // exactly the capacity
+    const char e[] = { '0', '1', '2', '3', '4', '5', '6', '7' };
+    check(ring.push(e, 4, e + 4, 4), "spans of the capacity fit");
+    ring.pop(out, 8);
+    check(out[0] == '0' && out[7] == '7', "spans of the capacity in order");
+}
+
+int main()
+{
+    testCapacity();
+    testFullEmpty();
+    testWraparound();
+    testIndexOverflow();
+    testTwoSpans();
+
+    if (failures == 0)
+    {
+        printf("all passed\n");
+    }
+
+    return failures;
+}